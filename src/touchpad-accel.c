@@ -0,0 +1,188 @@
+/*
+ * Copyright © 2013 Red Hat, Inc.
+ *
+ * Permission to use, copy, modify, distribute, and sell this software
+ * and its documentation for any purpose is hereby granted without
+ * fee, provided that the above copyright notice appear in all copies
+ * and that both that copyright notice and this permission notice
+ * appear in supporting documentation, and that the name of Red Hat
+ * not be used in advertising or publicity pertaining to distribution
+ * of the software without specific, written prior permission.  Red
+ * Hat makes no representations about the suitability of this software
+ * for any purpose.  It is provided "as is" without express or implied
+ * warranty.
+ *
+ * THE AUTHORS DISCLAIM ALL WARRANTIES WITH REGARD TO THIS SOFTWARE,
+ * INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS, IN
+ * NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY SPECIAL, INDIRECT OR
+ * CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS
+ * OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT,
+ * NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+ * CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "touchpad-int.h"
+#include "touchpad-config.h"
+
+/**
+ * Fill the curve's lookup table. Entry i is the gain in 1/256 for a
+ * speed of i * max_speed/(ACCEL_LUT_SIZE - 1) units/s.
+ *
+ * Below the threshold, the gain is min_factor. Between the threshold and
+ * max_speed it rises to max_factor, linearly or along a smoothstep curve
+ * depending on the profile.
+ */
+void
+touchpad_accel_curve_init(struct accel_curve *curve,
+			  enum touchpad_accel_profile profile,
+			  int min_factor, int max_factor,
+			  int threshold, int max_speed)
+{
+	int min_gain = min_factor * 256/100;
+	int max_gain = max(min_factor, max_factor) * 256/100;
+
+	curve->max_speed = max_speed;
+
+	for (int i = 0; i < ACCEL_LUT_SIZE; i++) {
+		int speed = (int64_t)i * max_speed/(ACCEL_LUT_SIZE - 1);
+		int64_t t; /* position between threshold and max_speed, 1/256 */
+		int gain;
+
+		if (speed <= threshold || threshold >= max_speed)
+			t = 0;
+		else
+			t = (int64_t)(speed - threshold) * 256/(max_speed - threshold);
+
+		switch (profile) {
+			case TOUCHPAD_ACCEL_PROFILE_LINEAR:
+				break;
+			case TOUCHPAD_ACCEL_PROFILE_SMOOTH:
+				/* 3t² - 2t³ */
+				t = (3 * 256 * t * t - 2 * t * t * t)/(256 * 256);
+				break;
+			default:
+				t = 0;
+				break;
+		}
+
+		gain = min_gain + (max_gain - min_gain) * t/256;
+		curve->gain[i] = min(gain, UINT16_MAX);
+	}
+}
+
+/**
+ * @return the gain in 1/256 for the given speed in units/s
+ */
+int
+touchpad_accel_curve_gain(const struct accel_curve *curve, int speed)
+{
+	int index;
+
+	if (speed >= curve->max_speed)
+		return curve->gain[ACCEL_LUT_SIZE - 1];
+
+	index = (int64_t)speed * (ACCEL_LUT_SIZE - 1)/curve->max_speed;
+
+	return curve->gain[index];
+}
+
+/**
+ * Apply the gain to a delta, carrying the fractional part over to the
+ * next call in *remainder (1/256 units).
+ */
+int
+touchpad_accel_apply_gain(int delta, int gain, int *remainder)
+{
+	int scaled = delta * gain + *remainder;
+	int out = scaled/256;
+
+	*remainder = scaled - out * 256;
+
+	return out;
+}
+
+/**
+ * Approximate the length of (x, y) without a square root, within about
+ * 7%. That's plenty to pick a lookup table entry.
+ */
+static inline int
+approx_hypot(int x, int y)
+{
+	int a = abs(x), b = abs(y);
+	int hi = max(a, b), lo = min(a, b);
+
+	return hi + lo * 3/8;
+}
+
+/**
+ * Build the curve for the current config and geometry. The speeds are
+ * configured in mm/s, the curve works in x units/s.
+ */
+void
+touchpad_accel_init(struct touchpad *tp)
+{
+	const struct accel_config *config = &tp->accel.config;
+	int xres = tp->geometry.xres;
+
+	touchpad_accel_curve_init(&tp->accel.curve,
+				  config->profile,
+				  config->min_factor,
+				  config->max_factor,
+				  config->threshold * xres,
+				  config->max_speed * xres);
+	touchpad_accel_reset(tp);
+}
+
+void
+touchpad_accel_reset(struct touchpad *tp)
+{
+	tp->accel.remainder_x = 0;
+	tp->accel.remainder_y = 0;
+}
+
+/**
+ * @return the speed of touch t in x units/s. That's the touch's velocity
+ * if a filter stage calculated one, otherwise it is taken from the
+ * frame's delta dx/dy and the time since the last frame. Without
+ * either, the touch is treated as not moving.
+ */
+int
+touchpad_accel_touch_speed(struct touchpad *tp, struct touch *t, int dx, int dy)
+{
+	int last, dt;
+
+	if (t->vx || t->vy)
+		return approx_hypot(t->vx, touchpad_geometry_y_to_x(tp, t->vy));
+
+	last = touchpad_history_get_last(t);
+	dt = last >= 0 ? (int)(tp->ms - touchpad_history_millis(t, last)) : 0;
+
+	return dt > 0 ? approx_hypot(dx, touchpad_geometry_y_to_x(tp, dy)) * 1000/dt : 0;
+}
+
+/**
+ * Accelerate the pointer delta of touch t, see
+ * touchpad_accel_touch_speed() for the speed it's accelerated by.
+ *
+ * The y delta is converted to x units on the way, so both axes move the
+ * pointer the same distance for the same finger movement.
+ */
+void
+touchpad_accel_filter(struct touchpad *tp, struct touch *t, int *dx, int *dy)
+{
+	int speed, gain;
+
+	if (tp->accel.config.profile == TOUCHPAD_ACCEL_PROFILE_NONE)
+		return;
+
+	speed = touchpad_accel_touch_speed(tp, t, *dx, *dy);
+	gain = touchpad_accel_curve_gain(&tp->accel.curve, speed);
+
+	*dx = touchpad_accel_apply_gain(*dx, gain, &tp->accel.remainder_x);
+	*dy = touchpad_accel_apply_gain(*dy, gain * 256/tp->geometry.anisotropy,
+					&tp->accel.remainder_y);
+}
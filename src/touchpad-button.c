@@ -553,10 +553,10 @@ touchpad_button_handle_state(struct touchpad *tp, void *userdata)
 	}
 
 	if (tp->queued & EVENT_BUTTON_RELEASE)
-		tp->interface->button(tp, userdata, tp->buttons.active_softbutton, false);
+		tp->interface.button(tp, userdata, tp->buttons.active_softbutton, false);
 
 	if (tp->queued & EVENT_BUTTON_PRESS) {
-		tp->interface->button(tp, userdata, button, true);
+		tp->interface.button(tp, userdata, button, true);
 		tp->buttons.active_softbutton = button;
 	}
 
@@ -582,6 +582,61 @@ touchpad_button_handle_timeout(struct touchpad *tp, unsigned int now, void *user
 	return min_timeout == INT_MAX ? 0 : min_timeout;
 }
 
+/**
+ * A touch that rests in the button area for thumb_timeout without moving
+ * is a thumb, e.g. a thumb ready to click. Thumbs don't count in
+ * fingers_down and take no part in tapping and scrolling, but they still
+ * go through the soft button state machine so they can click. A thumb
+ * that leaves the button area is a finger again.
+ */
+void
+touchpad_button_detect_thumbs(struct touchpad *tp)
+{
+	int64_t threshold = tp->buttons.thumb_move_threshold;
+	struct touch *t;
+
+	if (tp->buttons.config.thumb_timeout == 0)
+		return;
+
+	touchpad_for_each_touch(tp, t) {
+		const struct touch_origin *origin;
+		int dx, dy;
+
+		if (t->state != TOUCH_UPDATE || t->fake)
+			continue;
+
+		if (t->thumb_state != THUMB_STATE_NO) {
+			if (!is_inside_button_area(tp, t)) {
+				t->thumb_state = THUMB_STATE_NO;
+				tp->thumbs_down--;
+				tp->fingers_down++;
+			}
+			continue;
+		}
+
+		origin = touchpad_touch_origin(tp, t);
+		if (!is_inside_button_area(tp, t) ||
+		    tp->ms - origin->millis < tp->buttons.config.thumb_timeout)
+			continue;
+
+		dx = t->x - origin->x;
+		dy = touchpad_geometry_y_to_x(tp, t->y - origin->y);
+		if ((int64_t)dx * dx + (int64_t)dy * dy > threshold * threshold)
+			continue;
+
+		log_debug(tp, "touch %d: thumb\n", _i);
+		t->thumb_state = THUMB_STATE_NEW;
+		tp->thumbs_down++;
+		tp->fingers_down--;
+	}
+}
+
+bool
+touchpad_button_in_area(struct touchpad *tp, struct touch *t)
+{
+	return is_inside_button_area(tp, t);
+}
+
 bool
 touchpad_button_select_pointer_touch(struct touchpad *tp, struct touch *t)
 {
@@ -29,22 +29,64 @@
 #include <touchpad-int.h>
 #include <touchpad-config.h>
 
+#include <math.h>
 #include <stdarg.h>
 
 struct tap_config tap_defaults = {
 	.enabled = true,
 	.timeout_period = 180,
-	.move_threshold = 30,
+	.move_threshold = 400,
 };
 
 struct scroll_config scroll_defaults = {
 	.methods = TOUCHPAD_SCROLL_TWOFINGER_VERTICAL,
-	.vdelta = 100,
-	.hdelta = 100,
+	.vdelta = 1340,
+	.hdelta = 1340,
+	.edge_size = 7000,
+	.kinetic = false,
+	.kinetic_friction = 5,
+	.two_axis = false,
+	.axis_lock = 15,
+	.accel = {
+		.profile = TOUCHPAD_ACCEL_PROFILE_NONE,
+		.min_factor = 100,
+		.max_factor = 400,
+		.threshold = 40,
+		.max_speed = 400,
+	},
+};
+
+struct gesture_config gesture_defaults = {
+	.gestures = TOUCHPAD_GESTURE_PINCH | TOUCHPAD_GESTURE_ROTATE |
+		    TOUCHPAD_GESTURE_SWIPE,
+	.hold_timeout = 500,
+	.symbol_threshold = 15,
 };
 
 struct touchpad_config touchpad_defaults = {
 	.motion_history_size = 10,
+	.motion_filters = TOUCHPAD_MOTION_FILTER_JUMP |
+			  TOUCHPAD_MOTION_FILTER_HYSTERESIS |
+			  TOUCHPAD_MOTION_FILTER_AVERAGE,
+	.hysteresis_margin = 110,
+	.adaptive_min_cutoff = 1000,
+	.adaptive_beta = 1500,
+	.tracker_alpha = 500,
+	.tracker_beta = 150,
+	.prediction_time = 16,
+	.jump_max_speed = 2000,
+	.pressure_high = 0,
+	.pressure_low = 0,
+	.palm_size = 0,
+	.rest_frames = 10,
+};
+
+struct accel_config accel_defaults = {
+	.profile = TOUCHPAD_ACCEL_PROFILE_NONE,
+	.min_factor = 100,
+	.max_factor = 400,
+	.threshold = 13,
+	.max_speed = 133,
 };
 
 struct button_config button_defaults_static = {
@@ -53,6 +95,8 @@ struct button_config button_defaults_static = {
 	.right = {0, 0 },
 	.leave_timeout = 300,
 	.enter_timeout = 150,
+	.thumb_timeout = 300,
+	.thumb_move_threshold = 1500,
 };
 
 struct button_config button_defaults_dynamic = {
@@ -175,6 +219,32 @@ config_get_softbutton(struct touchpad *tp,
 	return 0;
 }
 
+static bool
+motion_filters_valid(unsigned int filters)
+{
+	const unsigned int all = TOUCHPAD_MOTION_FILTER_HYSTERESIS |
+				 TOUCHPAD_MOTION_FILTER_AVERAGE |
+				 TOUCHPAD_MOTION_FILTER_ADAPTIVE |
+				 TOUCHPAD_MOTION_FILTER_TRACKER |
+				 TOUCHPAD_MOTION_FILTER_PREDICT |
+				 TOUCHPAD_MOTION_FILTER_JUMP;
+
+	if (filters & ~all)
+		return false;
+
+	/* both are dejitter filters, one or the other */
+	if ((filters & TOUCHPAD_MOTION_FILTER_HYSTERESIS) &&
+	    (filters & TOUCHPAD_MOTION_FILTER_ADAPTIVE))
+		return false;
+
+	/* both calculate the delta, one or the other */
+	if ((filters & TOUCHPAD_MOTION_FILTER_AVERAGE) &&
+	    (filters & TOUCHPAD_MOTION_FILTER_TRACKER))
+		return false;
+
+	return true;
+}
+
 /**
  * @return 0 on success, 1 for a bad key, -1 for a bad value
  */
@@ -201,16 +271,25 @@ touchpad_config_set_key_value(struct touchpad *tp,
 			apply_value(tp->tap.config.timeout_period, value, tap_defaults.timeout_period);
 			break;
 		case TOUCHPAD_CONFIG_TAP_MOVE_THRESHOLD:
-			apply_value(tp->tap.config.timeout_period, value, tap_defaults.timeout_period);
+			if (value < 0)
+				return config_error(TOUCHPAD_CONFIG_ERROR_VALUE_TOO_LOW, error);
+			apply_value(tp->tap.config.move_threshold, value, tap_defaults.move_threshold);
+			touchpad_config_apply_geometry(tp);
 			break;
 		case TOUCHPAD_CONFIG_SCROLL_METHOD:
 			apply_value(tp->scroll.config.methods, value, scroll_defaults.methods);
 			break;
 		case TOUCHPAD_CONFIG_SCROLL_DELTA_VERT:
+			if (value <= 0)
+				return config_error(TOUCHPAD_CONFIG_ERROR_VALUE_TOO_LOW, error);
 			apply_value(tp->scroll.config.vdelta, value, scroll_defaults.vdelta);
+			touchpad_config_apply_geometry(tp);
 			break;
 		case TOUCHPAD_CONFIG_SCROLL_DELTA_HORIZ:
+			if (value <= 0)
+				return config_error(TOUCHPAD_CONFIG_ERROR_VALUE_TOO_LOW, error);
 			apply_value(tp->scroll.config.hdelta, value, scroll_defaults.hdelta);
+			touchpad_config_apply_geometry(tp);
 			break;
 		case TOUCHPAD_CONFIG_MOTION_HISTORY_SIZE:
 			if (value <= 0)
@@ -225,11 +304,209 @@ touchpad_config_set_key_value(struct touchpad *tp,
 		case TOUCHPAD_CONFIG_SOFTBUTTON_ENTER_TIMEOUT:
 			apply_value(tp->buttons.config.enter_timeout, value, button_defaults_static.enter_timeout);
 			break;
+		case TOUCHPAD_CONFIG_THUMB_TIMEOUT:
+			if (value < 0)
+				return config_error(TOUCHPAD_CONFIG_ERROR_VALUE_TOO_LOW, error);
+			apply_value(tp->buttons.config.thumb_timeout, value, button_defaults_static.thumb_timeout);
+			break;
+		case TOUCHPAD_CONFIG_THUMB_MOVE_THRESHOLD:
+			if (value < 0)
+				return config_error(TOUCHPAD_CONFIG_ERROR_VALUE_TOO_LOW, error);
+			apply_value(tp->buttons.config.thumb_move_threshold, value, button_defaults_static.thumb_move_threshold);
+			touchpad_config_apply_geometry(tp);
+			break;
 		case TOUCHPAD_CONFIG_SOFTBUTTON_TOP:
 		case TOUCHPAD_CONFIG_SOFTBUTTON_BOTTOM:
 		case TOUCHPAD_CONFIG_SOFTBUTTON_RBTN_LEFT:
 		case TOUCHPAD_CONFIG_SOFTBUTTON_RBTN_RIGHT:
 			return config_set_softbutton(tp, error, key, value);
+		case TOUCHPAD_CONFIG_MOTION_FILTERS:
+			if (value != TOUCHPAD_CONFIG_USE_DEFAULT &&
+			    !motion_filters_valid(value))
+				return config_error(TOUCHPAD_CONFIG_ERROR_VALUE_INVALID, error);
+			apply_value(tp->config.motion_filters, value, touchpad_defaults.motion_filters);
+			touchpad_filter_init(tp);
+			break;
+		case TOUCHPAD_CONFIG_HYSTERESIS_MARGIN:
+			if (value < 0)
+				return config_error(TOUCHPAD_CONFIG_ERROR_VALUE_TOO_LOW, error);
+			apply_value(tp->config.hysteresis_margin, value, touchpad_defaults.hysteresis_margin);
+			touchpad_config_apply_geometry(tp);
+			break;
+		case TOUCHPAD_CONFIG_ADAPTIVE_MIN_CUTOFF:
+			if (value <= 0)
+				return config_error(TOUCHPAD_CONFIG_ERROR_VALUE_TOO_LOW, error);
+			apply_value(tp->config.adaptive_min_cutoff, value, touchpad_defaults.adaptive_min_cutoff);
+			break;
+		case TOUCHPAD_CONFIG_ADAPTIVE_BETA:
+			if (value < 0)
+				return config_error(TOUCHPAD_CONFIG_ERROR_VALUE_TOO_LOW, error);
+			apply_value(tp->config.adaptive_beta, value, touchpad_defaults.adaptive_beta);
+			break;
+		case TOUCHPAD_CONFIG_TRACKER_ALPHA:
+			if (value <= 0)
+				return config_error(TOUCHPAD_CONFIG_ERROR_VALUE_TOO_LOW, error);
+			if (value > 1000 && value != TOUCHPAD_CONFIG_USE_DEFAULT)
+				return config_error(TOUCHPAD_CONFIG_ERROR_VALUE_TOO_HIGH, error);
+			apply_value(tp->config.tracker_alpha, value, touchpad_defaults.tracker_alpha);
+			break;
+		case TOUCHPAD_CONFIG_TRACKER_BETA:
+			if (value < 0)
+				return config_error(TOUCHPAD_CONFIG_ERROR_VALUE_TOO_LOW, error);
+			if (value > 1000 && value != TOUCHPAD_CONFIG_USE_DEFAULT)
+				return config_error(TOUCHPAD_CONFIG_ERROR_VALUE_TOO_HIGH, error);
+			apply_value(tp->config.tracker_beta, value, touchpad_defaults.tracker_beta);
+			break;
+		case TOUCHPAD_CONFIG_PREDICTION_TIME:
+			if (value < 0)
+				return config_error(TOUCHPAD_CONFIG_ERROR_VALUE_TOO_LOW, error);
+			if (value > 100 && value != TOUCHPAD_CONFIG_USE_DEFAULT)
+				return config_error(TOUCHPAD_CONFIG_ERROR_VALUE_TOO_HIGH, error);
+			apply_value(tp->config.prediction_time, value, touchpad_defaults.prediction_time);
+			break;
+		case TOUCHPAD_CONFIG_ACCEL_PROFILE:
+			if (value < TOUCHPAD_ACCEL_PROFILE_NONE ||
+			    (value > TOUCHPAD_ACCEL_PROFILE_SMOOTH &&
+			     value != TOUCHPAD_CONFIG_USE_DEFAULT))
+				return config_error(TOUCHPAD_CONFIG_ERROR_VALUE_INVALID, error);
+			apply_value(tp->accel.config.profile, value, accel_defaults.profile);
+			touchpad_accel_init(tp);
+			break;
+		case TOUCHPAD_CONFIG_ACCEL_MIN_FACTOR:
+			if (value <= 0)
+				return config_error(TOUCHPAD_CONFIG_ERROR_VALUE_TOO_LOW, error);
+			if (value > 10000 && value != TOUCHPAD_CONFIG_USE_DEFAULT)
+				return config_error(TOUCHPAD_CONFIG_ERROR_VALUE_TOO_HIGH, error);
+			apply_value(tp->accel.config.min_factor, value, accel_defaults.min_factor);
+			touchpad_accel_init(tp);
+			break;
+		case TOUCHPAD_CONFIG_ACCEL_MAX_FACTOR:
+			if (value <= 0)
+				return config_error(TOUCHPAD_CONFIG_ERROR_VALUE_TOO_LOW, error);
+			if (value > 10000 && value != TOUCHPAD_CONFIG_USE_DEFAULT)
+				return config_error(TOUCHPAD_CONFIG_ERROR_VALUE_TOO_HIGH, error);
+			apply_value(tp->accel.config.max_factor, value, accel_defaults.max_factor);
+			touchpad_accel_init(tp);
+			break;
+		case TOUCHPAD_CONFIG_ACCEL_THRESHOLD:
+			if (value < 0)
+				return config_error(TOUCHPAD_CONFIG_ERROR_VALUE_TOO_LOW, error);
+			apply_value(tp->accel.config.threshold, value, accel_defaults.threshold);
+			touchpad_accel_init(tp);
+			break;
+		case TOUCHPAD_CONFIG_ACCEL_MAX_SPEED:
+			if (value <= 0)
+				return config_error(TOUCHPAD_CONFIG_ERROR_VALUE_TOO_LOW, error);
+			apply_value(tp->accel.config.max_speed, value, accel_defaults.max_speed);
+			touchpad_accel_init(tp);
+			break;
+		case TOUCHPAD_CONFIG_JUMP_MAX_SPEED:
+			if (value <= 0)
+				return config_error(TOUCHPAD_CONFIG_ERROR_VALUE_TOO_LOW, error);
+			apply_value(tp->config.jump_max_speed, value, touchpad_defaults.jump_max_speed);
+			break;
+		case TOUCHPAD_CONFIG_PRESSURE_HIGH:
+			if (value < 0)
+				return config_error(TOUCHPAD_CONFIG_ERROR_VALUE_TOO_LOW, error);
+			if (value > 100 && value != TOUCHPAD_CONFIG_USE_DEFAULT)
+				return config_error(TOUCHPAD_CONFIG_ERROR_VALUE_TOO_HIGH, error);
+			apply_value(tp->config.pressure_high, value, touchpad_defaults.pressure_high);
+			touchpad_config_apply_geometry(tp);
+			break;
+		case TOUCHPAD_CONFIG_PRESSURE_LOW:
+			if (value < 0)
+				return config_error(TOUCHPAD_CONFIG_ERROR_VALUE_TOO_LOW, error);
+			if (value > 100 && value != TOUCHPAD_CONFIG_USE_DEFAULT)
+				return config_error(TOUCHPAD_CONFIG_ERROR_VALUE_TOO_HIGH, error);
+			apply_value(tp->config.pressure_low, value, touchpad_defaults.pressure_low);
+			touchpad_config_apply_geometry(tp);
+			break;
+		case TOUCHPAD_CONFIG_PALM_SIZE:
+			if (value < 0)
+				return config_error(TOUCHPAD_CONFIG_ERROR_VALUE_TOO_LOW, error);
+			apply_value(tp->config.palm_size, value, touchpad_defaults.palm_size);
+			touchpad_config_apply_geometry(tp);
+			break;
+		case TOUCHPAD_CONFIG_REST_FRAMES:
+			if (value < 0)
+				return config_error(TOUCHPAD_CONFIG_ERROR_VALUE_TOO_LOW, error);
+			apply_value(tp->config.rest_frames, value, touchpad_defaults.rest_frames);
+			break;
+		case TOUCHPAD_CONFIG_SCROLL_EDGE_SIZE:
+			if (value < 0)
+				return config_error(TOUCHPAD_CONFIG_ERROR_VALUE_TOO_LOW, error);
+			apply_value(tp->scroll.config.edge_size, value, scroll_defaults.edge_size);
+			touchpad_config_apply_geometry(tp);
+			break;
+		case TOUCHPAD_CONFIG_GESTURES:
+			if (value != TOUCHPAD_CONFIG_USE_DEFAULT &&
+			    (value & ~(TOUCHPAD_GESTURE_PINCH|TOUCHPAD_GESTURE_ROTATE|
+				       TOUCHPAD_GESTURE_SWIPE|TOUCHPAD_GESTURE_HOLD|
+				       TOUCHPAD_GESTURE_SYMBOL)))
+				return config_error(TOUCHPAD_CONFIG_ERROR_VALUE_INVALID, error);
+			apply_value(tp->gesture.config.gestures, value, gesture_defaults.gestures);
+			break;
+		case TOUCHPAD_CONFIG_SCROLL_KINETIC:
+			apply_value(tp->scroll.config.kinetic, value, scroll_defaults.kinetic);
+			break;
+		case TOUCHPAD_CONFIG_SCROLL_KINETIC_FRICTION:
+			if (value < 1)
+				return config_error(TOUCHPAD_CONFIG_ERROR_VALUE_TOO_LOW, error);
+			if (value > 99 && value != TOUCHPAD_CONFIG_USE_DEFAULT)
+				return config_error(TOUCHPAD_CONFIG_ERROR_VALUE_TOO_HIGH, error);
+			apply_value(tp->scroll.config.kinetic_friction, value, scroll_defaults.kinetic_friction);
+			break;
+		case TOUCHPAD_CONFIG_SCROLL_TWO_AXIS:
+			apply_value(tp->scroll.config.two_axis, value, scroll_defaults.two_axis);
+			break;
+		case TOUCHPAD_CONFIG_SCROLL_AXIS_LOCK:
+			if (value < 0)
+				return config_error(TOUCHPAD_CONFIG_ERROR_VALUE_TOO_LOW, error);
+			if (value > 45 && value != TOUCHPAD_CONFIG_USE_DEFAULT)
+				return config_error(TOUCHPAD_CONFIG_ERROR_VALUE_TOO_HIGH, error);
+			apply_value(tp->scroll.config.axis_lock, value, scroll_defaults.axis_lock);
+			touchpad_config_apply_geometry(tp);
+			break;
+		case TOUCHPAD_CONFIG_SCROLL_ACCEL_PROFILE:
+			if (value < TOUCHPAD_ACCEL_PROFILE_NONE ||
+			    (value > TOUCHPAD_ACCEL_PROFILE_SMOOTH &&
+			     value != TOUCHPAD_CONFIG_USE_DEFAULT))
+				return config_error(TOUCHPAD_CONFIG_ERROR_VALUE_INVALID, error);
+			apply_value(tp->scroll.config.accel.profile, value, scroll_defaults.accel.profile);
+			touchpad_scroll_accel_init(tp);
+			break;
+		case TOUCHPAD_CONFIG_SCROLL_ACCEL_MAX_FACTOR:
+			if (value < 100)
+				return config_error(TOUCHPAD_CONFIG_ERROR_VALUE_TOO_LOW, error);
+			if (value > 10000 && value != TOUCHPAD_CONFIG_USE_DEFAULT)
+				return config_error(TOUCHPAD_CONFIG_ERROR_VALUE_TOO_HIGH, error);
+			apply_value(tp->scroll.config.accel.max_factor, value, scroll_defaults.accel.max_factor);
+			touchpad_scroll_accel_init(tp);
+			break;
+		case TOUCHPAD_CONFIG_SCROLL_ACCEL_THRESHOLD:
+			if (value < 0)
+				return config_error(TOUCHPAD_CONFIG_ERROR_VALUE_TOO_LOW, error);
+			apply_value(tp->scroll.config.accel.threshold, value, scroll_defaults.accel.threshold);
+			touchpad_scroll_accel_init(tp);
+			break;
+		case TOUCHPAD_CONFIG_SCROLL_ACCEL_MAX_SPEED:
+			if (value <= 0)
+				return config_error(TOUCHPAD_CONFIG_ERROR_VALUE_TOO_LOW, error);
+			apply_value(tp->scroll.config.accel.max_speed, value, scroll_defaults.accel.max_speed);
+			touchpad_scroll_accel_init(tp);
+			break;
+		case TOUCHPAD_CONFIG_HOLD_TIMEOUT:
+			if (value <= 0)
+				return config_error(TOUCHPAD_CONFIG_ERROR_VALUE_TOO_LOW, error);
+			apply_value(tp->gesture.config.hold_timeout, value, gesture_defaults.hold_timeout);
+			break;
+		case TOUCHPAD_CONFIG_SYMBOL_THRESHOLD:
+			if (value <= 0)
+				return config_error(TOUCHPAD_CONFIG_ERROR_VALUE_TOO_LOW, error);
+			if (value > 100 && value != TOUCHPAD_CONFIG_USE_DEFAULT)
+				return config_error(TOUCHPAD_CONFIG_ERROR_VALUE_TOO_HIGH, error);
+			apply_value(tp->gesture.config.symbol_threshold, value, gesture_defaults.symbol_threshold);
+			break;
 		default:
 			return config_error(TOUCHPAD_CONFIG_ERROR_KEY_INVALID, error);
 	}
@@ -293,7 +570,7 @@ touchpad_config_get_key_value(struct touchpad *tp,
 			*value = tp->tap.config.timeout_period;
 			break;
 		case TOUCHPAD_CONFIG_TAP_MOVE_THRESHOLD:
-			*value = tp->tap.config.timeout_period;
+			*value = tp->tap.config.move_threshold;
 			break;
 		case TOUCHPAD_CONFIG_SCROLL_METHOD:
 			*value = tp->scroll.config.methods;
@@ -313,11 +590,104 @@ touchpad_config_get_key_value(struct touchpad *tp,
 		case TOUCHPAD_CONFIG_SOFTBUTTON_ENTER_TIMEOUT:
 			*value = tp->buttons.config.enter_timeout;
 			break;
+		case TOUCHPAD_CONFIG_THUMB_TIMEOUT:
+			*value = tp->buttons.config.thumb_timeout;
+			break;
+		case TOUCHPAD_CONFIG_THUMB_MOVE_THRESHOLD:
+			*value = tp->buttons.config.thumb_move_threshold;
+			break;
 		case TOUCHPAD_CONFIG_SOFTBUTTON_TOP:
 		case TOUCHPAD_CONFIG_SOFTBUTTON_BOTTOM:
 		case TOUCHPAD_CONFIG_SOFTBUTTON_RBTN_LEFT:
 		case TOUCHPAD_CONFIG_SOFTBUTTON_RBTN_RIGHT:
 			return config_get_softbutton(tp, key, value);
+		case TOUCHPAD_CONFIG_MOTION_FILTERS:
+			*value = tp->config.motion_filters;
+			break;
+		case TOUCHPAD_CONFIG_HYSTERESIS_MARGIN:
+			*value = tp->config.hysteresis_margin;
+			break;
+		case TOUCHPAD_CONFIG_ADAPTIVE_MIN_CUTOFF:
+			*value = tp->config.adaptive_min_cutoff;
+			break;
+		case TOUCHPAD_CONFIG_ADAPTIVE_BETA:
+			*value = tp->config.adaptive_beta;
+			break;
+		case TOUCHPAD_CONFIG_TRACKER_ALPHA:
+			*value = tp->config.tracker_alpha;
+			break;
+		case TOUCHPAD_CONFIG_TRACKER_BETA:
+			*value = tp->config.tracker_beta;
+			break;
+		case TOUCHPAD_CONFIG_PREDICTION_TIME:
+			*value = tp->config.prediction_time;
+			break;
+		case TOUCHPAD_CONFIG_ACCEL_PROFILE:
+			*value = tp->accel.config.profile;
+			break;
+		case TOUCHPAD_CONFIG_ACCEL_MIN_FACTOR:
+			*value = tp->accel.config.min_factor;
+			break;
+		case TOUCHPAD_CONFIG_ACCEL_MAX_FACTOR:
+			*value = tp->accel.config.max_factor;
+			break;
+		case TOUCHPAD_CONFIG_ACCEL_THRESHOLD:
+			*value = tp->accel.config.threshold;
+			break;
+		case TOUCHPAD_CONFIG_ACCEL_MAX_SPEED:
+			*value = tp->accel.config.max_speed;
+			break;
+		case TOUCHPAD_CONFIG_JUMP_MAX_SPEED:
+			*value = tp->config.jump_max_speed;
+			break;
+		case TOUCHPAD_CONFIG_PRESSURE_HIGH:
+			*value = tp->config.pressure_high;
+			break;
+		case TOUCHPAD_CONFIG_PRESSURE_LOW:
+			*value = tp->config.pressure_low;
+			break;
+		case TOUCHPAD_CONFIG_PALM_SIZE:
+			*value = tp->config.palm_size;
+			break;
+		case TOUCHPAD_CONFIG_REST_FRAMES:
+			*value = tp->config.rest_frames;
+			break;
+		case TOUCHPAD_CONFIG_SCROLL_EDGE_SIZE:
+			*value = tp->scroll.config.edge_size;
+			break;
+		case TOUCHPAD_CONFIG_GESTURES:
+			*value = tp->gesture.config.gestures;
+			break;
+		case TOUCHPAD_CONFIG_SCROLL_KINETIC:
+			*value = tp->scroll.config.kinetic;
+			break;
+		case TOUCHPAD_CONFIG_SCROLL_KINETIC_FRICTION:
+			*value = tp->scroll.config.kinetic_friction;
+			break;
+		case TOUCHPAD_CONFIG_SCROLL_TWO_AXIS:
+			*value = tp->scroll.config.two_axis;
+			break;
+		case TOUCHPAD_CONFIG_SCROLL_AXIS_LOCK:
+			*value = tp->scroll.config.axis_lock;
+			break;
+		case TOUCHPAD_CONFIG_SCROLL_ACCEL_PROFILE:
+			*value = tp->scroll.config.accel.profile;
+			break;
+		case TOUCHPAD_CONFIG_SCROLL_ACCEL_MAX_FACTOR:
+			*value = tp->scroll.config.accel.max_factor;
+			break;
+		case TOUCHPAD_CONFIG_SCROLL_ACCEL_THRESHOLD:
+			*value = tp->scroll.config.accel.threshold;
+			break;
+		case TOUCHPAD_CONFIG_SCROLL_ACCEL_MAX_SPEED:
+			*value = tp->scroll.config.accel.max_speed;
+			break;
+		case TOUCHPAD_CONFIG_HOLD_TIMEOUT:
+			*value = tp->gesture.config.hold_timeout;
+			break;
+		case TOUCHPAD_CONFIG_SYMBOL_THRESHOLD:
+			*value = tp->gesture.config.symbol_threshold;
+			break;
 		default:
 			return 1;
 	}
@@ -361,13 +731,73 @@ touchpad_config_set_static_defaults(struct touchpad *tp)
 {
 	tp->tap.config = tap_defaults;
 	tp->scroll.config = scroll_defaults;
+	tp->gesture.config = gesture_defaults;
 	tp->buttons.config = button_defaults_static;
 	tp->config = touchpad_defaults;
+	tp->accel.config = accel_defaults;
+	touchpad_filter_init(tp);
+	touchpad_config_apply_geometry(tp);
+}
+
+/**
+ * Convert the touch qualification thresholds to device units. The
+ * pressure thresholds are relative to the pressure axis, the low
+ * threshold is capped at the high one. The palm size uses the resolution
+ * of the touch size axis. Without one, the axis range is taken to span
+ * the width of the touchpad.
+ */
+static void
+config_apply_qualify(struct touchpad *tp)
+{
+	struct qualify *q = &tp->qualify;
+	int range = q->pressure_max - q->pressure_min;
+	int low = min(tp->config.pressure_low, tp->config.pressure_high);
+
+	if (range > 0 && tp->config.pressure_high > 0) {
+		q->pressure_high = max(1, q->pressure_min + range * tp->config.pressure_high/100);
+		q->pressure_low = q->pressure_min + range * low/100;
+	} else {
+		q->pressure_high = 0;
+		q->pressure_low = 0;
+	}
+
+	range = q->major_max - q->major_min;
+	if (range <= 0 || tp->config.palm_size <= 0)
+		q->palm_major = 0;
+	else if (q->major_res > 0)
+		q->palm_major = max(1, (int64_t)tp->config.palm_size * q->major_res/1000);
+	else
+		q->palm_major = max(1, q->major_min + (int64_t)range * tp->config.palm_size/
+				       (max(1, tp->geometry.width) * 1000));
+	q->enabled = q->pressure_high || q->palm_major;
+}
+
+/**
+ * Convert the thresholds configured in µm or relative to an axis to
+ * device units for the current geometry. This also rebuilds the
+ * acceleration curves, their speeds are configured in mm/s.
+ */
+void
+touchpad_config_apply_geometry(struct touchpad *tp)
+{
+	tp->tap.move_threshold = touchpad_geometry_x_units(tp, tp->tap.config.move_threshold);
+	tp->scroll.hdist = max(1, touchpad_geometry_x_units(tp, tp->scroll.config.hdelta));
+	tp->scroll.vdist = max(1, touchpad_geometry_y_units(tp, tp->scroll.config.vdelta));
+	tp->scroll.edge_right = tp->geometry.maxx - touchpad_geometry_x_units(tp, tp->scroll.config.edge_size);
+	tp->scroll.edge_bottom = tp->geometry.maxy - touchpad_geometry_y_units(tp, tp->scroll.config.edge_size);
+	tp->scroll.axis_lock_slope = tan(tp->scroll.config.axis_lock * M_PI/180);
+	tp->filter.margin_x = touchpad_geometry_x_units(tp, tp->config.hysteresis_margin);
+	tp->filter.margin_y = touchpad_geometry_y_units(tp, tp->config.hysteresis_margin);
+	tp->buttons.thumb_move_threshold = touchpad_geometry_x_units(tp, tp->buttons.config.thumb_move_threshold);
+	config_apply_qualify(tp);
+	touchpad_accel_init(tp);
+	touchpad_scroll_accel_init(tp);
 }
 
 void
 touchpad_config_set_dynamic_defaults(struct touchpad *tp)
 {
+	touchpad_config_apply_geometry(tp);
 	touchpad_config_set(tp, NULL,
 			TOUCHPAD_CONFIG_SOFTBUTTON_TOP, button_defaults_dynamic.top,
 			TOUCHPAD_CONFIG_SOFTBUTTON_BOTTOM, button_defaults_dynamic.bottom,
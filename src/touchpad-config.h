@@ -35,15 +35,111 @@
  * functionality.
  */
 
+/**
+ * Filters applied to the touch motion, see
+ * TOUCHPAD_CONFIG_MOTION_FILTERS.
+ */
+enum touchpad_motion_filters {
+	TOUCHPAD_MOTION_FILTER_NONE = 0x0,
+	/**
+	 * Ignore movements within TOUCHPAD_CONFIG_HYSTERESIS_MARGIN of the
+	 * previous position.
+	 */
+	TOUCHPAD_MOTION_FILTER_HYSTERESIS = 0x1,
+	/**
+	 * Average the delta over TOUCHPAD_CONFIG_MOTION_HISTORY_SIZE
+	 * frames.
+	 */
+	TOUCHPAD_MOTION_FILTER_AVERAGE = 0x2,
+	/**
+	 * Speed-adaptive low-pass filter: smooth heavily when the finger
+	 * is nearly still, follow closely when it moves fast. See
+	 * TOUCHPAD_CONFIG_ADAPTIVE_MIN_CUTOFF and
+	 * TOUCHPAD_CONFIG_ADAPTIVE_BETA. This filter is an alternative to
+	 * TOUCHPAD_MOTION_FILTER_HYSTERESIS, only one of the two may be
+	 * enabled.
+	 */
+	TOUCHPAD_MOTION_FILTER_ADAPTIVE = 0x4,
+	/**
+	 * Estimate position and velocity with a constant-velocity tracker
+	 * and use the estimate for the delta. See
+	 * TOUCHPAD_CONFIG_TRACKER_ALPHA and TOUCHPAD_CONFIG_TRACKER_BETA.
+	 * This filter is an alternative to TOUCHPAD_MOTION_FILTER_AVERAGE,
+	 * only one of the two may be enabled.
+	 */
+	TOUCHPAD_MOTION_FILTER_TRACKER = 0x8,
+	/**
+	 * Extrapolate the motion TOUCHPAD_CONFIG_PREDICTION_TIME ms ahead
+	 * to compensate for the latency of the other filters. The
+	 * prediction is dropped whenever the touch slows down or changes
+	 * direction.
+	 */
+	TOUCHPAD_MOTION_FILTER_PREDICT = 0x10,
+	/**
+	 * Discard positions that imply a finger speed above
+	 * TOUCHPAD_CONFIG_JUMP_MAX_SPEED, some firmwares occasionally send
+	 * a single wild coordinate. See touchpad_get_jump_count().
+	 */
+	TOUCHPAD_MOTION_FILTER_JUMP = 0x20,
+};
+
+/**
+ * Multi-finger, hold and symbol gestures, see TOUCHPAD_CONFIG_GESTURES.
+ */
+enum touchpad_gestures {
+	TOUCHPAD_GESTURE_NONE = 0x0,
+	/** Fingers moving apart or together, see touchpad_interface::pinch */
+	TOUCHPAD_GESTURE_PINCH = 0x1,
+	/** Fingers turning around each other, see touchpad_interface::rotate */
+	TOUCHPAD_GESTURE_ROTATE = 0x2,
+	/**
+	 * Three or more fingers moving together, see
+	 * touchpad_interface::swipe_begin
+	 */
+	TOUCHPAD_GESTURE_SWIPE = 0x4,
+	/**
+	 * One finger resting for TOUCHPAD_CONFIG_HOLD_TIMEOUT, see
+	 * touchpad_interface::hold_begin
+	 */
+	TOUCHPAD_GESTURE_HOLD = 0x8,
+	/**
+	 * One finger tracing one of the registered templates, see
+	 * touchpad_symbol_add_template()
+	 */
+	TOUCHPAD_GESTURE_SYMBOL = 0x10,
+};
+
+/**
+ * Pointer acceleration profiles, see TOUCHPAD_CONFIG_ACCEL_PROFILE.
+ */
+enum touchpad_accel_profile {
+	/** Deltas are passed on in device units */
+	TOUCHPAD_ACCEL_PROFILE_NONE = 0,
+	/* With all other profiles, vertical deltas are converted to
+	 * horizontal device units first, so the same finger movement moves
+	 * the pointer the same distance on both axes. */
+	/** Deltas are scaled by TOUCHPAD_CONFIG_ACCEL_MIN_FACTOR */
+	TOUCHPAD_ACCEL_PROFILE_FLAT,
+	/**
+	 * The factor rises linearly from TOUCHPAD_CONFIG_ACCEL_MIN_FACTOR
+	 * at TOUCHPAD_CONFIG_ACCEL_THRESHOLD to
+	 * TOUCHPAD_CONFIG_ACCEL_MAX_FACTOR at
+	 * TOUCHPAD_CONFIG_ACCEL_MAX_SPEED.
+	 */
+	TOUCHPAD_ACCEL_PROFILE_LINEAR,
+	/** Like the linear profile, but along an s-shaped curve */
+	TOUCHPAD_ACCEL_PROFILE_SMOOTH,
+};
+
 enum touchpad_config_parameter {
 	TOUCHPAD_CONFIG_NONE = 0,
 	TOUCHPAD_CONFIG_TAP_ENABLE,
 	TOUCHPAD_CONFIG_TAP_TIMEOUT,
 	TOUCHPAD_CONFIG_TAP_DOUBLETAP_TIMEOUT,
-	TOUCHPAD_CONFIG_TAP_MOVE_THRESHOLD,
+	TOUCHPAD_CONFIG_TAP_MOVE_THRESHOLD, /* in µm */
 	TOUCHPAD_CONFIG_SCROLL_METHOD,
-	TOUCHPAD_CONFIG_SCROLL_DELTA_VERT,
-	TOUCHPAD_CONFIG_SCROLL_DELTA_HORIZ,
+	TOUCHPAD_CONFIG_SCROLL_DELTA_VERT, /* in µm per scroll unit */
+	TOUCHPAD_CONFIG_SCROLL_DELTA_HORIZ, /* in µm per scroll unit */
 	TOUCHPAD_CONFIG_MOTION_HISTORY_SIZE,
 	TOUCHPAD_CONFIG_SOFTBUTTON_TOP, /* in % of the height */
 	TOUCHPAD_CONFIG_SOFTBUTTON_BOTTOM, /* 0 for bottom, 1 for top */
@@ -66,6 +162,158 @@ enum touchpad_config_parameter {
 	 */
 	TOUCHPAD_CONFIG_SOFTBUTTON_ENTER_TIMEOUT,
 
+	/**
+	 * A bitmask of enum touchpad_motion_filters. With no filters
+	 * enabled, the delta is the raw difference to the previous frame.
+	 */
+	TOUCHPAD_CONFIG_MOTION_FILTERS,
+	/**
+	 * The margin in µm for TOUCHPAD_MOTION_FILTER_HYSTERESIS.
+	 */
+	TOUCHPAD_CONFIG_HYSTERESIS_MARGIN,
+	/**
+	 * The cutoff frequency in mHz of TOUCHPAD_MOTION_FILTER_ADAPTIVE
+	 * for a finger that isn't moving. Lower values reduce jitter but
+	 * increase lag for slow movements.
+	 */
+	TOUCHPAD_CONFIG_ADAPTIVE_MIN_CUTOFF,
+	/**
+	 * The increase of the cutoff frequency of
+	 * TOUCHPAD_MOTION_FILTER_ADAPTIVE in mHz per mm/s.
+	 * Higher values reduce lag for fast movements.
+	 */
+	TOUCHPAD_CONFIG_ADAPTIVE_BETA,
+	/**
+	 * The position gain of TOUCHPAD_MOTION_FILTER_TRACKER in 1/1000,
+	 * 1 to 1000. Lower values smooth more but react slower.
+	 */
+	TOUCHPAD_CONFIG_TRACKER_ALPHA,
+	/**
+	 * The velocity gain of TOUCHPAD_MOTION_FILTER_TRACKER in 1/1000,
+	 * 0 to 1000. Lower values smooth the velocity more but react slower
+	 * to changes in speed.
+	 */
+	TOUCHPAD_CONFIG_TRACKER_BETA,
+	/**
+	 * How far ahead TOUCHPAD_MOTION_FILTER_PREDICT predicts, in ms,
+	 * 0 to 100.
+	 */
+	TOUCHPAD_CONFIG_PREDICTION_TIME,
+
+	/**
+	 * The pointer acceleration profile, one of enum
+	 * touchpad_accel_profile. Acceleration is off by default.
+	 */
+	TOUCHPAD_CONFIG_ACCEL_PROFILE,
+	TOUCHPAD_CONFIG_ACCEL_MIN_FACTOR, /* in %, the factor for slow movements */
+	TOUCHPAD_CONFIG_ACCEL_MAX_FACTOR, /* in %, the factor for fast movements */
+	TOUCHPAD_CONFIG_ACCEL_THRESHOLD, /* in mm/s */
+	TOUCHPAD_CONFIG_ACCEL_MAX_SPEED, /* in mm/s */
+
+	/**
+	 * The highest plausible finger speed in mm/s for
+	 * TOUCHPAD_MOTION_FILTER_JUMP.
+	 */
+	TOUCHPAD_CONFIG_JUMP_MAX_SPEED,
+
+	/**
+	 * The pressure in % of the pressure range a new contact needs to
+	 * count as a touch, 0 to 100. Lighter contacts, e.g. a hovering
+	 * finger, are ignored. 0 disables the check, the default, since
+	 * the pressure a finger reports varies too much between devices.
+	 * Devices without a per-touch pressure ignore this unless they
+	 * only track a single contact.
+	 */
+	TOUCHPAD_CONFIG_PRESSURE_HIGH,
+	/**
+	 * The pressure in % of the pressure range below which a touch
+	 * ends, 0 to 100. Capped at TOUCHPAD_CONFIG_PRESSURE_HIGH.
+	 */
+	TOUCHPAD_CONFIG_PRESSURE_LOW,
+	/**
+	 * Contacts whose major axis is this size in µm or larger are
+	 * palms and ignored. 0 disables the check, the default. Only used
+	 * on devices that report ABS_MT_TOUCH_MAJOR.
+	 */
+	TOUCHPAD_CONFIG_PALM_SIZE,
+
+	/**
+	 * On clickpads, a touch that rests in the software button area
+	 * for this many ms, moving less than
+	 * TOUCHPAD_CONFIG_THUMB_MOVE_THRESHOLD, is a thumb. Thumbs can
+	 * click but don't count as fingers for tapping and scrolling.
+	 * 0 disables thumb detection.
+	 */
+	TOUCHPAD_CONFIG_THUMB_TIMEOUT,
+	TOUCHPAD_CONFIG_THUMB_MOVE_THRESHOLD, /* in µm */
+
+	/**
+	 * A touch that stays within TOUCHPAD_CONFIG_HYSTERESIS_MARGIN for
+	 * this many frames rests: it isn't processed until it leaves the
+	 * margin. 0 disables this.
+	 */
+	TOUCHPAD_CONFIG_REST_FRAMES,
+
+	/**
+	 * Enable kinetic scrolling: when the fingers lift off during a
+	 * two-finger scroll, scrolling continues at the speed the fingers
+	 * had and slows down until it stops. Off by default.
+	 */
+	TOUCHPAD_CONFIG_SCROLL_KINETIC,
+	/**
+	 * How quickly kinetic scrolling slows down, in % of the scroll
+	 * speed lost every 10ms, 1 to 99.
+	 */
+	TOUCHPAD_CONFIG_SCROLL_KINETIC_FRICTION,
+	/**
+	 * The width of the right and the height of the bottom edge zone
+	 * for edge scrolling, in µm. 0 disables edge scrolling.
+	 */
+	TOUCHPAD_CONFIG_SCROLL_EDGE_SIZE,
+
+	/**
+	 * A bitmask of enum touchpad_gestures to enable. Defaults to
+	 * all gestures except TOUCHPAD_GESTURE_HOLD and
+	 * TOUCHPAD_GESTURE_SYMBOL.
+	 */
+	TOUCHPAD_CONFIG_GESTURES,
+
+	/**
+	 * Scroll on both axes at once: a diagonal two-finger movement
+	 * scrolls diagonally instead of along one axis only. Only takes
+	 * effect if both TOUCHPAD_SCROLL_TWOFINGER_VERTICAL and
+	 * TOUCHPAD_SCROLL_TWOFINGER_HORIZONTAL are enabled. Off by default.
+	 */
+	TOUCHPAD_CONFIG_SCROLL_TWO_AXIS,
+	/**
+	 * For two-axis scrolling, a movement within this many degrees of
+	 * one axis only scrolls along that axis, 0 to 45. 0 disables the
+	 * lock.
+	 */
+	TOUCHPAD_CONFIG_SCROLL_AXIS_LOCK,
+
+	/**
+	 * The scroll acceleration profile, one of enum
+	 * touchpad_accel_profile. Slow scrolling is never slowed down, the
+	 * factor starts at 100%. Acceleration is off by default.
+	 */
+	TOUCHPAD_CONFIG_SCROLL_ACCEL_PROFILE,
+	TOUCHPAD_CONFIG_SCROLL_ACCEL_MAX_FACTOR, /* in %, the factor for fast scrolling, 100 or more */
+	TOUCHPAD_CONFIG_SCROLL_ACCEL_THRESHOLD, /* in mm/s */
+	TOUCHPAD_CONFIG_SCROLL_ACCEL_MAX_SPEED, /* in mm/s */
+
+	/**
+	 * How long in ms a finger must rest before it's a hold, see
+	 * TOUCHPAD_GESTURE_HOLD.
+	 */
+	TOUCHPAD_CONFIG_HOLD_TIMEOUT,
+
+	/**
+	 * How far a stroke may be from a template and still match it, in %
+	 * of the symbol's size, 1 to 100. See TOUCHPAD_GESTURE_SYMBOL.
+	 */
+	TOUCHPAD_CONFIG_SYMBOL_THRESHOLD,
+
 	TOUCHPAD_CONFIG_LAST,
 	/**
 	 * Use the built-in defaults for the preceding parameter.
@@ -43,6 +43,13 @@ touchpad_begin_touch(struct touchpad *tp, struct touch *t, int tracking_id)
 	if (t->state == TOUCH_NONE || t->state == TOUCH_END) {
 		tp->fingers_down++;
 		argcheck_int_ge(tp->fingers_down, 1);
+
+		/* The slot may have ended a touch earlier in this frame,
+		   nothing of its classification carries over */
+		t->thumb_state = THUMB_STATE_NO;
+		t->scroll_edge = SCROLL_EDGE_NONE;
+		t->button_state = BUTTON_STATE_NONE;
+		t->button_timeout = 0;
 	}
 
 
@@ -63,12 +70,18 @@ touchpad_begin_touch(struct touchpad *tp, struct touch *t, int tracking_id)
 static void
 touchpad_end_touch(struct touchpad *tp, struct touch *t)
 {
+	t->hovering = false;
+
 	if (t->state == TOUCH_NONE)
 		return;
 
 	t->state = TOUCH_END;
-	tp->fingers_down--;
+	if (t->thumb_state != THUMB_STATE_NO)
+		tp->thumbs_down--;
+	else
+		tp->fingers_down--;
 	argcheck_int_ge(tp->fingers_down, 0);
+	argcheck_int_ge(tp->thumbs_down, 0);
 	t->dirty = true;
 	tp->queued |= EVENT_MOTION;
 }
@@ -94,6 +107,14 @@ touchpad_mt_update_abs_state(struct touchpad *tp,
 			t->dirty = true;
 			tp->queued |= EVENT_MOTION;
 			break;
+		case ABS_MT_PRESSURE:
+			t->pressure = ev->value;
+			tp->queued |= EVENT_MOTION;
+			break;
+		case ABS_MT_TOUCH_MAJOR:
+			t->major = ev->value;
+			tp->queued |= EVENT_MOTION;
+			break;
 		case ABS_MT_SLOT:
 			tp->slot = ev->value;
 			t = touchpad_current_touch(tp);
@@ -108,11 +129,40 @@ touchpad_mt_update_abs_state(struct touchpad *tp,
 			break;
 	}
 
-	t->millis = timeval_to_millis(&ev->time);
-
 	return rc;
 }
 
+/**
+ * The slots of a semi-MT touchpad carry the corners of the bounding box
+ * of the fingers. The tracking IDs are handled as on a true MT touchpad,
+ * so the number of touches is correct, but the positions are kept aside
+ * until the end of the frame, see touchpad_semi_mt_update_touches().
+ */
+int
+touchpad_semi_mt_update_abs_state(struct touchpad *tp,
+				  const struct input_event *ev)
+{
+	switch (ev->code) {
+		case ABS_MT_POSITION_X:
+		case ABS_MT_POSITION_Y:
+			if (tp->slot < 0 || tp->slot >= (int)ARRAY_LENGTH(tp->semi_mt.x))
+				return 0;
+
+			if (ev->code == ABS_MT_POSITION_X)
+				tp->semi_mt.x[tp->slot] = ev->value;
+			else
+				tp->semi_mt.y[tp->slot] = ev->value;
+			tp->queued |= EVENT_MOTION;
+			return 0;
+		case ABS_PRESSURE:
+			tp->qualify.pressure = ev->value;
+			tp->queued |= EVENT_MOTION;
+			return 0;
+	}
+
+	return touchpad_mt_update_abs_state(tp, ev);
+}
+
 int
 touchpad_st_update_abs_state(struct touchpad *tp,
 			     const struct input_event *ev)
@@ -131,6 +181,10 @@ touchpad_st_update_abs_state(struct touchpad *tp,
 			t->dirty = true;
 			tp->queued |= EVENT_MOTION;
 			break;
+		case ABS_PRESSURE:
+			tp->qualify.pressure = ev->value;
+			tp->queued |= EVENT_MOTION;
+			break;
 		case ABS_MT_POSITION_X:
 		case ABS_MT_POSITION_Y:
 		case ABS_MT_SLOT:
@@ -139,8 +193,6 @@ touchpad_st_update_abs_state(struct touchpad *tp,
 			break;
 	}
 
-	t->millis = timeval_to_millis(&ev->time);
-
 	return rc;
 }
 
@@ -227,14 +279,43 @@ touchpad_update_button_state(struct touchpad *tp,
 	}
 }
 
+/**
+ * Restart the history of t at its current position, so the next delta
+ * doesn't include where the touch was before.
+ */
+static void
+touchpad_rebase_touch(struct touchpad *tp, struct touch *t)
+{
+	touchpad_history_reset(tp, t);
+	touchpad_history_push(t, t->x, t->y, tp->ms);
+}
+
+/**
+ * Make t the pointer touch. A touch that was down before it took over
+ * may have moved in the meantime, e.g. while it was pinned or in a
+ * software button area, and that motion is still in its history. Rebase
+ * the history on the current position so the first delta of the new
+ * pointer is zero and the filters start afresh.
+ */
+static void
+touchpad_handoff_pointer(struct touchpad *tp, struct touch *t)
+{
+	t->pointer = true;
+	touchpad_accel_reset(tp);
+
+	if (t->state == TOUCH_UPDATE)
+		touchpad_rebase_touch(tp, t);
+}
+
 static void
 touchpad_unpin_finger(struct touchpad *tp)
 {
 	struct touch *t = touchpad_pinned_touch(tp);
 	if (t) {
 		t->pinned = false;
-		if (tp->fingers_down == 1)
-			t->pointer = true;
+		if (tp->fingers_down == 1 && !t->pointer &&
+		    t->thumb_state == THUMB_STATE_NO)
+			touchpad_handoff_pointer(tp, t);
 	}
 }
 
@@ -249,7 +330,7 @@ touchpad_pin_finger(struct touchpad *tp)
 	if (t)
 		return;
 
-	if (tp->fingers_down == 1) /* Whoopee, the easy case */
+	if (tp->fingers_down + tp->thumbs_down == 1) /* Whoopee, the easy case */
 		t = touchpad_pointer_touch(tp);
 	else {
 		int maxy = INT_MIN;
@@ -266,8 +347,9 @@ touchpad_pin_finger(struct touchpad *tp)
 		}
 
 		argcheck_ptr_not_null(new_pointer_touch);
-		if (new_pointer_touch->state != TOUCH_NONE)
-			new_pointer_touch->pointer = true;
+		if (new_pointer_touch->state != TOUCH_NONE &&
+		    !new_pointer_touch->pointer)
+			touchpad_handoff_pointer(tp, new_pointer_touch);
 	}
 
 	if (t) {
@@ -292,9 +374,10 @@ touchpad_post_motion_events(struct touchpad *tp, void *userdata)
 		return;
 
 	touchpad_motion_to_delta(t, &dx, &dy);
+	touchpad_accel_filter(tp, t, &dx, &dy);
 
 	if (dx || dy)
-		tp->interface->motion(tp, userdata, dx, dy);
+		tp->interface.motion(tp, userdata, dx, dy);
 
 }
 
@@ -304,8 +387,10 @@ touchpad_update_pointer_touch(struct touchpad *tp)
 	struct touch *t;
 
 	t = touchpad_pointer_touch(tp);
-	if (t && t->state == TOUCH_END)
+	if (t && t->state == TOUCH_END) {
 		t->pointer = false;
+		touchpad_accel_reset(tp);
+	}
 }
 
 static void
@@ -317,27 +402,90 @@ touchpad_select_pointer_touch(struct touchpad *tp)
 		return;
 
 	touchpad_for_each_touch(tp, t) {
+		if (t->thumb_state != THUMB_STATE_NO)
+			continue;
+
 		if (tp->buttons.select_pointer_touch(tp, t)) {
-			t->pointer = true;
+			touchpad_handoff_pointer(tp, t);
 			break;
 		}
 	}
 }
 
+/**
+ * Derive the touches of a semi-MT touchpad from the bounding box. A
+ * single finger is reported as is. With more fingers, we don't know which
+ * finger is in which corner, so all touches, including the fake ones for
+ * a third finger, are put in the centre of the box, which moves with the
+ * fingers.
+ *
+ * When the number of fingers changes, the touches jump between a finger
+ * and the centre. Their history is rebased so that jump isn't motion.
+ */
+static void
+touchpad_semi_mt_update_touches(struct touchpad *tp)
+{
+	struct semi_mt *semi_mt = &tp->semi_mt;
+	struct touch *t;
+	int nfingers = 0;
+
+	touchpad_for_each_touch(tp, t) {
+		if (t->state == TOUCH_BEGIN || t->state == TOUCH_UPDATE)
+			nfingers++;
+	}
+
+	touchpad_for_each_touch(tp, t) {
+		int x, y;
+
+		if (t->state != TOUCH_BEGIN && t->state != TOUCH_UPDATE)
+			continue;
+
+		if (nfingers == 1 && _i < (int)ARRAY_LENGTH(semi_mt->x)) {
+			x = semi_mt->x[_i];
+			y = semi_mt->y[_i];
+		} else {
+			x = (semi_mt->x[0] + semi_mt->x[1])/2;
+			y = (semi_mt->y[0] + semi_mt->y[1])/2;
+		}
+
+		if (t->x != x || t->y != y) {
+			t->x = x;
+			t->y = y;
+			t->dirty = true;
+		}
+
+		if (nfingers != semi_mt->nfingers && t->state == TOUCH_UPDATE)
+			touchpad_rebase_touch(tp, t);
+	}
+
+	semi_mt->nfingers = nfingers;
+}
+
 static void
 touchpad_pre_process_touches(struct touchpad *tp, void *userdata)
 {
 	struct touch *t;
 
-	touchpad_select_pointer_touch(tp);
+	if (tp->semi_mt.enabled)
+		touchpad_semi_mt_update_touches(tp);
 
 	touchpad_for_each_touch(tp, t) {
-		if (t->state == TOUCH_BEGIN)
-			touchpad_history_push(t, t->x, t->y, t->millis);
-		if (t->state != TOUCH_NONE && t->dirty)
-			touchpad_motion_dejitter(t);
+		if (t->state == TOUCH_BEGIN) {
+			struct touch_origin *origin = touchpad_touch_origin(tp, t);
+
+			origin->x = t->x;
+			origin->y = t->y;
+			origin->millis = tp->ms;
+		}
 	}
 
+	if (tp->buttons.detect_thumbs)
+		tp->buttons.detect_thumbs(tp);
+	touchpad_scroll_detect_edges(tp);
+
+	touchpad_select_pointer_touch(tp);
+	touchpad_motion_update(tp);
+
 	if (tp->queued & EVENT_BUTTON_PRESS)
 		touchpad_pin_finger(tp);
 }
@@ -349,7 +497,10 @@ touchpad_touch_reset(struct touchpad *tp, struct touch *t)
 	t->pointer = false;
 	t->pinned = false;
 	t->fake = false;
+	t->resting = false;
 	t->button_state = BUTTON_STATE_NONE;
+	t->thumb_state = THUMB_STATE_NO;
+	t->scroll_edge = SCROLL_EDGE_NONE;
 	touchpad_history_reset(tp, t);
 }
 
@@ -362,13 +513,17 @@ touchpad_post_process_touches(struct touchpad *tp)
 		if (t->state == TOUCH_NONE)
 			continue;
 
-		touchpad_history_push(t, t->x, t->y, t->millis);
+		if (!t->resting)
+			touchpad_history_push(t, t->x, t->y, tp->ms);
 
 		if (t->state == TOUCH_END)
 			touchpad_touch_reset(tp, t);
 		 else if (t->state == TOUCH_BEGIN)
 			t->state = TOUCH_UPDATE;
 
+		if (t->thumb_state == THUMB_STATE_NEW)
+			t->thumb_state = THUMB_STATE_YES;
+
 		t->dirty = false;
 	}
 
@@ -380,14 +535,223 @@ touchpad_post_process_touches(struct touchpad *tp)
 	touchpad_update_pointer_touch(tp);
 }
 
+/**
+ * @return true if the contact is firm and small enough to be a finger. A
+ * touch that is already down only has to stay above the low pressure
+ * threshold, so a finger near the high threshold doesn't flicker.
+ */
+static bool
+touchpad_touch_qualifies(struct touchpad *tp, const struct touch *t)
+{
+	const struct qualify *q = &tp->qualify;
+	int pressure;
+
+	/* fake touches have no pressure or size of their own */
+	if (t->fake)
+		return true;
+
+	if (q->palm_major && t->major >= q->palm_major)
+		return false;
+
+	if (!q->pressure_high)
+		return true;
+
+	pressure = q->mt_pressure ? t->pressure : q->pressure;
+	if (t->state == TOUCH_UPDATE)
+		return pressure >= q->pressure_low;
+
+	return pressure >= q->pressure_high;
+}
+
+/**
+ * Keep contacts that aren't fingers, e.g. a hovering finger or a palm,
+ * away from everything else. A new touch that doesn't qualify is kept in
+ * TOUCH_NONE as hovering until it does, a touch that stops qualifying
+ * ends. This runs first in each frame, so tapping, buttons, scrolling and
+ * motion only ever see qualified touches.
+ */
+static void
+touchpad_qualify_touches(struct touchpad *tp)
+{
+	struct touch *t;
+
+	touchpad_for_each_touch(tp, t) {
+		switch (t->state) {
+			case TOUCH_BEGIN:
+				if (touchpad_touch_qualifies(tp, t))
+					break;
+
+				/* If the slot ended a touch in this frame,
+				   that end must still be seen */
+				if (touchpad_history_get_last(t) >= 0)
+					t->state = TOUCH_END;
+				else
+					t->state = TOUCH_NONE;
+				tp->fingers_down--;
+				t->hovering = true;
+				break;
+			case TOUCH_UPDATE:
+				if (touchpad_touch_qualifies(tp, t))
+					break;
+
+				log_debug(tp, "touch %d: disqualified, pressure %d size %d\n",
+					  _i, t->pressure, t->major);
+				touchpad_end_touch(tp, t);
+				t->hovering = true;
+				break;
+			case TOUCH_NONE:
+				if (t->hovering && touchpad_touch_qualifies(tp, t)) {
+					t->hovering = false;
+					touchpad_begin_touch(tp, t, t->number);
+				}
+				break;
+			case TOUCH_END:
+				break;
+		}
+	}
+}
+
+/**
+ * Collect the frame's metrics and decide which recognizers get to look at
+ * it. A recognizer that has started, i.e. a scroll, a pinch, a swipe or
+ * a hold, owns the frame until it ends. When a scroll takes over, any
+ * other undecided gesture is cancelled. Otherwise the number of fingers
+ * decides, and a frame where nothing moved, began or ended is skipped
+ * entirely, unless a scroll just ended. Undecided gestures always see the
+ * frame so they notice when the fingers change.
+ *
+ * The pointer is a candidate whenever a touch moved, it gets the frame if
+ * no other recognizer consumed it.
+ *
+ * Symbols never consume a frame, they only watch the pointer's stroke and
+ * are cancelled by whatever else starts on the finger.
+ *
+ * Tapping isn't arbitrated, it needs to see every frame to time the
+ * touches.
+ */
+static void
+touchpad_frame_classify(struct touchpad *tp, void *userdata)
+{
+	struct frame *f = &tp->frame;
+	unsigned int methods = tp->scroll.config.methods;
+	unsigned int gestures = touchpad_gesture_enabled(tp);
+	bool scrolling = tp->scroll.state != SCROLL_STATE_NONE;
+	struct touch *t;
+	bool changed = f->fingers != tp->fingers_down;
+
+	/* the scroll let go of the fingers, the ones still down get another
+	 * look even if they don't move */
+	if (f->scrolling && !scrolling)
+		changed = true;
+
+	f->fingers = tp->fingers_down;
+	f->moving = 0;
+	f->began = 0;
+	f->ended = 0;
+	f->edge = 0;
+	f->candidates = 0;
+
+	touchpad_for_each_touch(tp, t) {
+		switch (t->state) {
+			case TOUCH_BEGIN:
+				f->began++;
+				break;
+			case TOUCH_END:
+				f->ended++;
+				continue;
+			case TOUCH_UPDATE:
+				if (t->thumb_state == THUMB_STATE_NO && (t->dx || t->dy))
+					f->moving++;
+				break;
+			default:
+				continue;
+		}
+
+		if (t->scroll_edge != SCROLL_EDGE_NONE)
+			f->edge++;
+	}
+
+	if (f->moving)
+		f->candidates |= FRAME_POINTER;
+
+	if (tp->gesture.hold.state == HOLD_STATE_ACTIVE) {
+		f->candidates |= FRAME_HOLD;
+		return;
+	} else if (tp->gesture.swipe.active) {
+		f->candidates |= FRAME_SWIPE;
+		return;
+	} else if (tp->gesture.state == GESTURE_STATE_ACTIVE) {
+		f->candidates |= FRAME_PINCH;
+		return;
+	} else if (scrolling) {
+		/* the scroll took over, drop the undecided gestures once */
+		if (!f->scrolling)
+			touchpad_gesture_cancel(tp, userdata);
+		f->scrolling = true;
+		f->candidates |= FRAME_SCROLL;
+		return;
+	}
+
+	f->scrolling = false;
+
+	if (tp->gesture.state != GESTURE_STATE_NONE)
+		f->candidates |= FRAME_PINCH;
+	if (tp->gesture.swipe.fingers != 0)
+		f->candidates |= FRAME_SWIPE;
+	if (tp->gesture.hold.state != HOLD_STATE_NONE)
+		f->candidates |= FRAME_HOLD;
+	if (tp->symbol.state != SYMBOL_STATE_NONE)
+		f->candidates |= FRAME_SYMBOL;
+
+	if (!changed && !f->moving && !f->began && !f->ended)
+		return;
+
+	switch (f->fingers) {
+		case 0:
+			break;
+		case 1:
+			if (gestures & TOUCHPAD_GESTURE_HOLD)
+				f->candidates |= FRAME_HOLD;
+			if ((gestures & TOUCHPAD_GESTURE_SYMBOL) && tp->symbol.ntemplates)
+				f->candidates |= FRAME_SYMBOL;
+			if (f->edge && (methods & (TOUCHPAD_SCROLL_EDGE_VERTICAL|TOUCHPAD_SCROLL_EDGE_HORIZONTAL)))
+				f->candidates |= FRAME_SCROLL;
+			break;
+		case 2:
+			if (methods & (TOUCHPAD_SCROLL_TWOFINGER_VERTICAL|TOUCHPAD_SCROLL_TWOFINGER_HORIZONTAL))
+				f->candidates |= FRAME_SCROLL;
+			if (gestures & (TOUCHPAD_GESTURE_PINCH|TOUCHPAD_GESTURE_ROTATE))
+				f->candidates |= FRAME_PINCH;
+			break;
+		default:
+			if (gestures & TOUCHPAD_GESTURE_SWIPE)
+				f->candidates |= FRAME_SWIPE;
+			break;
+	}
+}
+
 static void
 touchpad_post_events(struct touchpad *tp, void *userdata)
 {
+	unsigned int candidates;
+	int rc = 0;
+
 	tp->buttons.handle_state(tp, userdata);
 	touchpad_tap_handle_state(tp, userdata);
-	if (touchpad_scroll_handle_state(tp, userdata) == 0) {
+
+	touchpad_frame_classify(tp, userdata);
+	candidates = tp->frame.candidates;
+
+	if (candidates & FRAME_SYMBOL)
+		touchpad_symbol_handle_state(tp, userdata);
+	if (candidates & FRAME_HOLD)
+		rc = touchpad_gesture_handle_hold(tp, userdata);
+	if (!rc && (candidates & (FRAME_PINCH|FRAME_SWIPE)))
+		rc = touchpad_gesture_handle_state(tp, userdata);
+	if (!rc && (candidates & FRAME_SCROLL))
+		rc = touchpad_scroll_handle_state(tp, userdata);
+	if (!rc && (candidates & FRAME_POINTER))
 		touchpad_post_motion_events(tp, userdata);
-	}
 }
 
 int
@@ -415,6 +779,8 @@ touchpad_handle_event(struct touchpad *tp,
 			if (tp->queued == EVENT_NONE)
 				break;
 			tp->ms = timeval_to_millis(&ev->time);
+			if (tp->qualify.enabled)
+				touchpad_qualify_touches(tp);
 			touchpad_pre_process_touches(tp, userdata);
 			touchpad_post_events(tp, userdata);
 			touchpad_post_process_touches(tp);
@@ -29,6 +29,76 @@
 #include <assert.h>
 #include <stdlib.h>
 #include "touchpad-int.h"
+#include "touchpad-config.h"
+
+static inline bool
+within_speed(int from, int to, int res, int max_speed, int dt)
+{
+	return (int64_t)abs(to - from) * 1000 <= (int64_t)max_speed * res * dt;
+}
+
+/**
+ * Discard positions the finger can't have reached since the last frame,
+ * some firmwares occasionally send a single wild coordinate. The touch
+ * stays at its previous position for that frame.
+ *
+ * If the next position is plausible from the discarded one rather than
+ * from the previous one, the touch really is there now, e.g. the
+ * firmware swapped two fingers. The history is rebased on the new
+ * position so the touch continues from there without a jump.
+ *
+ * If the frame has no usable timestamp, the position is passed through.
+ */
+static void
+touchpad_jump_filter_motion(struct touchpad *tp, struct touch *t)
+{
+	struct touch_filter_state *state = touchpad_filter_state(tp, t);
+	const struct touchpad_geometry *g = &tp->geometry;
+	int max_speed = tp->config.jump_max_speed;
+	int last = touchpad_history_get_last(t);
+	int dt = tp->ms - touchpad_history_millis(t, last);
+	int x = touchpad_history_x(t, last),
+	    y = touchpad_history_y(t, last);
+
+	if (dt <= 0 ||
+	    (within_speed(x, t->x, g->xres, max_speed, dt) &&
+	     within_speed(y, t->y, g->yres, max_speed, dt))) {
+		state->jump.pending = false;
+		return;
+	}
+
+	if (state->jump.pending &&
+	    within_speed(state->jump.x, t->x, g->xres, max_speed, dt) &&
+	    within_speed(state->jump.y, t->y, g->yres, max_speed, dt)) {
+		touchpad_history_reset(tp, t);
+		touchpad_history_push(t, t->x, t->y, tp->ms);
+		return;
+	}
+
+	log_debug(tp, "touch %d: discarding jump from %d/%d to %d/%d in %dms\n",
+		  (int)(t - tp->touches), x, y, t->x, t->y, dt);
+
+	state->jump.pending = true;
+	state->jump.x = t->x;
+	state->jump.y = t->y;
+	tp->filter.jumps++;
+
+	t->x = x;
+	t->y = y;
+}
+
+static void
+touchpad_jump_filter_reset(struct touchpad *tp, struct touch *t)
+{
+	touchpad_filter_state(tp, t)->jump.pending = false;
+}
+
+static const struct motion_filter jump_filter = {
+	.name = "jump",
+	.type = MOTION_FILTER_POSITION,
+	.process = touchpad_jump_filter_motion,
+	.reset = touchpad_jump_filter_reset,
+};
 
 static int
 hysteresis(int in, int center, int margin)
@@ -46,15 +116,136 @@ hysteresis(int in, int center, int margin)
 }
 
 static void
-touchpad_hysteresis_filter_motion(struct touch *t, int *x, int *y)
+touchpad_hysteresis_filter_motion(struct touchpad *tp, struct touch *t)
+{
+	int old = touchpad_history_get_last(t);
+
+	argcheck_int_ge(old, 0);
+
+	t->x = hysteresis(t->x, touchpad_history_x(t, old), tp->filter.margin_x);
+	t->y = hysteresis(t->y, touchpad_history_y(t, old), tp->filter.margin_y);
+}
+
+static const struct motion_filter hysteresis_filter = {
+	.name = "hysteresis",
+	.type = MOTION_FILTER_POSITION,
+	.process = touchpad_hysteresis_filter_motion,
+};
+
+/**
+ * @return the smoothing factor in 1/65536 of an exponential low-pass filter
+ * with a cutoff frequency of fc mHz, sampled every dt ms. This is
+ * dt/(dt + tau), with tau = 1/(2π fc).
+ */
+static inline int
+lowpass_alpha(int dt, int64_t fc)
+{
+	int64_t k = dt * fc * 6283/1000;
+
+	return k * 65536/(k + 1000000);
+}
+
+static int
+adaptive_filter_axis(const struct touchpad *tp, int *pos, int *speed,
+		     int in, int dt, int res)
 {
-	struct touch_history_point *old = touchpad_history_get_last(t);
-	const int hysteresis_margin = 8;
+	const int speed_cutoff = 1000; /* mHz */
+	int64_t fc;
+	int raw_speed;
 
-	argcheck_ptr_not_null(old);
+	in <<= 8;
 
-	*x = hysteresis(*x, old->x, hysteresis_margin);
-	*y = hysteresis(*y, old->y, hysteresis_margin);
+	raw_speed = (int64_t)(in - *pos) * 1000/dt/256;
+	*speed += (int64_t)lowpass_alpha(dt, speed_cutoff) * (raw_speed - *speed)/65536;
+
+	fc = tp->config.adaptive_min_cutoff +
+	     (int64_t)tp->config.adaptive_beta * abs(*speed)/res;
+	*pos += (int64_t)lowpass_alpha(dt, fc) * (in - *pos)/65536;
+
+	return (*pos + 128) >> 8;
+}
+
+/**
+ * A low-pass filter whose cutoff frequency rises with the speed of the
+ * touch (the "1€ filter", Casiez et al., CHI 2012). A still finger is
+ * smoothed heavily, a fast finger passes through with little lag. Each
+ * axis is filtered on its own.
+ *
+ * If the frame has no usable timestamp, the position is passed through
+ * unfiltered.
+ */
+static void
+touchpad_adaptive_filter_motion(struct touchpad *tp, struct touch *t)
+{
+	struct touch_filter_state *state = touchpad_filter_state(tp, t);
+	int last = touchpad_history_get_last(t);
+	int dt = tp->ms - touchpad_history_millis(t, last);
+
+	if (!state->adaptive.valid || dt <= 0) {
+		state->adaptive.valid = true;
+		state->adaptive.x = t->x << 8;
+		state->adaptive.y = t->y << 8;
+		return;
+	}
+
+	t->x = adaptive_filter_axis(tp, &state->adaptive.x,
+				    &state->adaptive.speed_x, t->x, dt,
+				    tp->geometry.xres);
+	t->y = adaptive_filter_axis(tp, &state->adaptive.y,
+				    &state->adaptive.speed_y, t->y, dt,
+				    tp->geometry.yres);
+}
+
+static void
+touchpad_adaptive_filter_reset(struct touchpad *tp, struct touch *t)
+{
+	struct touch_filter_state *state = touchpad_filter_state(tp, t);
+
+	state->adaptive.valid = false;
+	state->adaptive.speed_x = 0;
+	state->adaptive.speed_y = 0;
+}
+
+static const struct motion_filter adaptive_filter = {
+	.name = "adaptive",
+	.type = MOTION_FILTER_POSITION,
+	.process = touchpad_adaptive_filter_motion,
+	.reset = touchpad_adaptive_filter_reset,
+};
+
+/**
+ * Sum up n contiguous history values. n is at most
+ * MAX_MOTION_HISTORY_SIZE, too short for vectorizing to pay off.
+ */
+static inline int
+history_sum(const int16_t *v, int n)
+{
+	int sum = 0;
+
+	for (int i = 0; i < n; i++)
+		sum += v[i];
+
+	return sum;
+}
+
+/**
+ * Sum up the history entries of v from age first to age last (inclusive),
+ * where age 1 is the most recently pushed entry. The ring buffer wraps at
+ * most once, so this is one or two contiguous runs.
+ */
+static int
+history_sum_window(const struct touch_history *h, const int16_t *v,
+		   int first, int last)
+{
+	int size = h->size;
+	int start = ((int)h->index - last + size) % size;
+	int n = last - first + 1;
+	int run = min(n, size - start);
+
+	if (n <= 0)
+		return 0;
+
+	return history_sum(&v[start], run) + history_sum(v, n - run);
 }
 
 /**
@@ -65,46 +256,426 @@ touchpad_hysteresis_filter_motion(struct touch *t, int *x, int *y)
  *
  * For an uneven number of data points, just drop the last and pretend we
  * have an even number.
+ *
+ * The above assumes the points are evenly spaced in time. Devices that
+ * change their report rate or send bursts of events aren't, so the delta
+ * is scaled by how far apart the two halves actually are compared to how
+ * far apart they would be if every frame had the device's usual frame
+ * period. For evenly spaced frames this is a factor of 1, regardless of
+ * the report rate. The same sums give us the velocity.
+ *
+ * The period is the median of the recent frame intervals, not the
+ * current one, so the first frame after the device went quiet for a while
+ * is scaled down rather than up.
+ */
+static void
+touchpad_history_delta(struct touchpad *tp, struct touch *t)
+{
+	const struct touch_history *h = &t->history;
+	unsigned int now = tp->ms;
+	int npoints, half;
+	int sum_x, sum_y, sum_t;
+	int period = tp->frame.period;
+	int expected;
+
+	t->vx = 0;
+	t->vy = 0;
+
+	if (h->valid < h->size) {
+		t->dx = 0;
+		t->dy = 0;
+		return;
+	}
+
+	npoints = (1 + h->valid)/2 * 2;
+	half = npoints/2;
+
+	/* newer half minus older half, the current position is the first
+	   of the newer half. Both halves have the same number of points, so
+	   the origins the history is relative to cancel out */
+	sum_x = t->x - h->origin_x +
+		history_sum_window(h, h->x, 1, half - 1) -
+		history_sum_window(h, h->x, half, npoints - 1);
+	sum_y = t->y - h->origin_y +
+		history_sum_window(h, h->y, 1, half - 1) -
+		history_sum_window(h, h->y, half, npoints - 1);
+	sum_t = (int)(now - h->base_millis) +
+		history_sum_window(h, h->millis, 1, half - 1) -
+		history_sum_window(h, h->millis, half, npoints - 1);
+
+	expected = half * half * period;
+
+	/* Less than 1ms per frame on average means the timestamps are
+	   useless, don't weigh */
+	if (period <= 0 || sum_t < half * half) {
+		t->dx = sum_x/npoints;
+		t->dy = sum_y/npoints;
+		return;
+	}
+
+	t->vx = (int64_t)sum_x * 1000/sum_t;
+	t->vy = (int64_t)sum_y * 1000/sum_t;
+
+	/* don't let a single odd frame scale by more than 4 either way */
+	sum_t = max(expected/4, min(sum_t, expected * 4));
+	t->dx = (int64_t)sum_x * expected/((int64_t)npoints * sum_t);
+	t->dy = (int64_t)sum_y * expected/((int64_t)npoints * sum_t);
+}
+
+static const struct motion_filter average_filter = {
+	.name = "average",
+	.type = MOTION_FILTER_DELTA,
+	.process = touchpad_history_delta,
+};
+
+/**
+ * One step of the tracker for one axis.
+ * @return the delta of the estimated position, in device units
+ */
+static int
+tracker_axis(const struct touchpad *tp, int *pos, int *velocity, int in, int dt)
+{
+	int old = *pos;
+	int predicted = old + (int64_t)*velocity * dt * 256/1000;
+	int residual = (in << 8) - predicted;
+
+	*pos = predicted + (int64_t)tp->config.tracker_alpha * residual/1000;
+	*velocity += (int64_t)tp->config.tracker_beta * residual/(256 * dt);
+
+	return ((*pos + 128) >> 8) - ((old + 128) >> 8);
+}
+
+/**
+ * An alpha-beta filter: a constant-velocity model of the touch, corrected
+ * by a fixed fraction of the difference between the predicted and the
+ * measured position every frame. The delta is the movement of the
+ * estimated position, and the estimated velocity is exported in
+ * t->vx/vy. Unlike the history average this is O(1) per frame and
+ * doesn't need the history to fill up before the touch moves.
+ *
+ * If the frame has no usable timestamp, the raw delta is used.
+ */
+static void
+touchpad_tracker_filter_delta(struct touchpad *tp, struct touch *t)
+{
+	struct touch_filter_state *state = touchpad_filter_state(tp, t);
+	int last = touchpad_history_get_last(t);
+	int dt = tp->ms - touchpad_history_millis(t, last);
+
+	if (!state->tracker.valid || dt <= 0) {
+		state->tracker.valid = true;
+		state->tracker.x = t->x << 8;
+		state->tracker.y = t->y << 8;
+		return;
+	}
+
+	t->dx = tracker_axis(tp, &state->tracker.x, &state->tracker.vx, t->x, dt);
+	t->dy = tracker_axis(tp, &state->tracker.y, &state->tracker.vy, t->y, dt);
+	t->vx = state->tracker.vx;
+	t->vy = state->tracker.vy;
+}
+
+static void
+touchpad_tracker_filter_reset(struct touchpad *tp, struct touch *t)
+{
+	struct touch_filter_state *state = touchpad_filter_state(tp, t);
+
+	state->tracker.valid = false;
+	state->tracker.vx = 0;
+	state->tracker.vy = 0;
+}
+
+static const struct motion_filter tracker_filter = {
+	.name = "tracker",
+	.type = MOTION_FILTER_DELTA,
+	.process = touchpad_tracker_filter_delta,
+	.reset = touchpad_tracker_filter_reset,
+};
+
+/**
+ * One axis of the predictor.
+ * @param offset the prediction applied in the previous frame
+ * @param last_velocity the velocity of the previous frame
+ * @param raw the raw motion since the last frame
+ * @return the delta with the change in prediction applied
+ */
+static int
+predict_axis(int *offset, int *last_velocity, int velocity, int delta,
+	     int raw, int dt, int lookahead)
+{
+	int old = *offset;
+	int target = (int64_t)velocity * lookahead/1000;
+	int limit;
+
+	/* Only predict while the touch keeps going the same way. A change
+	 * of direction, or a frame moving against the velocity, means
+	 * we don't know where it's going next */
+	if ((int64_t)velocity * *last_velocity <= 0 ||
+	    (int64_t)velocity * raw < 0)
+		target = 0;
+	/* slowing down, the touch is likely to stop soon */
+	else if (abs(velocity) < abs(*last_velocity))
+		target = (int64_t)target * abs(velocity)/abs(*last_velocity);
+
+	/* never further ahead than this frame's motion would take us */
+	limit = (int64_t)abs(raw) * lookahead/dt;
+	target = max(-limit, min(target, limit));
+
+	*offset = target;
+	*last_velocity = velocity;
+
+	return delta + target - old;
+}
+
+/**
+ * Extrapolate the touch along its velocity, config.prediction_time ms
+ * ahead, to make up for the latency of the filters before it. The
+ * prediction is added to the delta as an offset that is taken back again
+ * when the touch slows down, stops or changes direction.
+ *
+ * The velocity is the one calculated by an earlier stage, or from the
+ * last few history entries if there is none.
+ */
+static void
+touchpad_predict_filter_delta(struct touchpad *tp, struct touch *t)
+{
+	struct touch_filter_state *state = touchpad_filter_state(tp, t);
+	int last = touchpad_history_get_last(t);
+	int dt = tp->ms - touchpad_history_millis(t, last);
+	int lookahead = tp->config.prediction_time;
+	int vx = t->vx, vy = t->vy;
+	int raw_x = t->x - touchpad_history_x(t, last),
+	    raw_y = t->y - touchpad_history_y(t, last);
+
+	if (dt <= 0) {
+		t->dx -= state->predict.offset_x;
+		t->dy -= state->predict.offset_y;
+		state->predict.offset_x = 0;
+		state->predict.offset_y = 0;
+		return;
+	}
+
+	if (vx == 0 && vy == 0) {
+		int first = touchpad_history_get(t, min(t->history.valid, 3));
+		int span = tp->ms - touchpad_history_millis(t, first);
+
+		if (span > 0) {
+			vx = (t->x - touchpad_history_x(t, first)) * 1000/span;
+			vy = (t->y - touchpad_history_y(t, first)) * 1000/span;
+		}
+	}
+
+	t->dx = predict_axis(&state->predict.offset_x, &state->predict.vx,
+			     vx, t->dx, raw_x, dt, lookahead);
+	t->dy = predict_axis(&state->predict.offset_y, &state->predict.vy,
+			     vy, t->dy, raw_y, dt, lookahead);
+}
+
+static void
+touchpad_predict_filter_reset(struct touchpad *tp, struct touch *t)
+{
+	struct touch_filter_state *state = touchpad_filter_state(tp, t);
+
+	state->predict.offset_x = 0;
+	state->predict.offset_y = 0;
+	state->predict.vx = 0;
+	state->predict.vy = 0;
+}
+
+static const struct motion_filter predict_filter = {
+	.name = "predict",
+	.type = MOTION_FILTER_DELTA,
+	.process = touchpad_predict_filter_delta,
+	.reset = touchpad_predict_filter_reset,
+};
+
+static void
+touchpad_passthrough_filter(struct touchpad *tp, struct touch *t)
+{
+}
+
+static const struct motion_filter passthrough_filter = {
+	.name = "passthrough",
+	.type = MOTION_FILTER_DELTA,
+	.process = touchpad_passthrough_filter,
+};
+
+static void
+filter_chain_append(struct touchpad *tp, const struct motion_filter *f)
+{
+	struct motion_filter_chain *chain = &tp->filter;
+
+	argcheck_int_lt(chain->nstages, MAX_MOTION_FILTERS);
+
+	chain->stages[chain->nstages++] = f;
+	if (f->type == MOTION_FILTER_POSITION)
+		chain->npositions++;
+}
+
+/**
+ * Build the filter chain from the configuration. Position filters run
+ * first, in the order listed here, followed by the delta filters. If no
+ * filter is enabled, the chain is a single passthrough stage and the
+ * delta is the raw difference to the previous frame.
  */
 void
-touchpad_motion_to_delta(struct touch *t, int *dx_out, int *dy_out)
+touchpad_filter_init(struct touchpad *tp)
 {
-	int i;
-	int dx = t->x,
-	    dy = t->y;
-	int npoints;
+	unsigned int filters = tp->config.motion_filters;
 
-	if (t->history.valid < t->history.size) {
-		*dx_out = 0;
-		*dy_out = 0;
+	tp->filter.nstages = 0;
+	tp->filter.npositions = 0;
+
+	if (filters & TOUCHPAD_MOTION_FILTER_JUMP)
+		filter_chain_append(tp, &jump_filter);
+	if (filters & TOUCHPAD_MOTION_FILTER_HYSTERESIS)
+		filter_chain_append(tp, &hysteresis_filter);
+	if (filters & TOUCHPAD_MOTION_FILTER_ADAPTIVE)
+		filter_chain_append(tp, &adaptive_filter);
+	if (filters & TOUCHPAD_MOTION_FILTER_AVERAGE)
+		filter_chain_append(tp, &average_filter);
+	if (filters & TOUCHPAD_MOTION_FILTER_TRACKER)
+		filter_chain_append(tp, &tracker_filter);
+	if (filters & TOUCHPAD_MOTION_FILTER_PREDICT)
+		filter_chain_append(tp, &predict_filter);
+
+	if (tp->filter.nstages == 0)
+		filter_chain_append(tp, &passthrough_filter);
+
+	for (int i = 0; i < tp->filter.nstages; i++)
+		if (tp->filter.stages[i]->init)
+			tp->filter.stages[i]->init(tp);
+}
+
+/**
+ * Add the interval since the previous frame to the samples of the frame
+ * period if a touch was down in both frames, and update the period.
+ */
+static void
+touchpad_frame_period_update(struct touchpad *tp, bool touching)
+{
+	int sorted[FRAME_PERIOD_SAMPLES];
+
+	if (!touching) {
+		tp->frame.last_ms = 0;
 		return;
 	}
 
-	npoints = (1 + t->history.valid)/2 * 2;
+	if (tp->frame.last_ms == 0) {
+		tp->frame.last_ms = tp->ms;
+		return;
+	}
+
+	tp->frame.dt[tp->frame.dt_index] = tp->ms - tp->frame.last_ms;
+	tp->frame.dt_index = (tp->frame.dt_index + 1) % FRAME_PERIOD_SAMPLES;
+	tp->frame.last_ms = tp->ms;
 
-	for (i = 1; i < npoints; i++) {
-		struct touch_history_point *p = touchpad_history_get(t, i);
+	/* insertion sort, there are only a handful */
+	for (int i = 0; i < FRAME_PERIOD_SAMPLES; i++) {
+		int j = i;
 
-		if ((i + 1) <= npoints/2) {
-			dx += p->x;
-			dy += p->y;
-		} else {
-			dx -= p->x;
-			dy -= p->y;
+		while (j > 0 && sorted[j - 1] > tp->frame.dt[i]) {
+			sorted[j] = sorted[j - 1];
+			j--;
 		}
+		sorted[j] = tp->frame.dt[i];
 	}
 
-	dx /= npoints;
-	dy /= npoints;
+	tp->frame.period = sorted[FRAME_PERIOD_SAMPLES/2];
+}
 
-	*dx_out = dx;
-	*dy_out = dy;
+/**
+ * @return true if the touch has stayed within the hysteresis margin for
+ * rest_frames frames. A resting touch keeps resting until it leaves the
+ * margin around the position where it came to rest. A touch never rests
+ * in the frame it begins or ends in, everything else needs to see those.
+ */
+static bool
+touchpad_touch_rests(struct touchpad *tp, struct touch *t)
+{
+	struct touch_filter_state *state = touchpad_filter_state(tp, t);
+
+	if (t->state == TOUCH_BEGIN || t->state == TOUCH_END ||
+	    abs(t->x - state->rest.x) > tp->filter.margin_x ||
+	    abs(t->y - state->rest.y) > tp->filter.margin_y) {
+		state->rest.x = t->x;
+		state->rest.y = t->y;
+		state->rest.frames = 0;
+		t->resting = false;
+		return false;
+	}
+
+	if (!t->resting && ++state->rest.frames >= tp->config.rest_frames)
+		t->resting = true;
+
+	return t->resting;
 }
 
+/**
+ * Process the motion of all touches for the current frame: seed the
+ * history of new touches, run the position filters on the touches that
+ * moved, then calculate the delta of every active touch and run the delta
+ * filters over it. The deltas are cached in the touch, so the button,
+ * tap, scroll and motion handlers all share the same value instead of
+ * each walking the history again.
+ *
+ * Touches that rest are skipped entirely: they have no delta, aren't
+ * dirty and their history isn't updated until they move again, so a hand
+ * resting on the touchpad costs next to nothing.
+ */
 void
-touchpad_motion_dejitter(struct touch *t)
+touchpad_motion_update(struct touchpad *tp)
 {
-	touchpad_hysteresis_filter_motion(t, &t->x, &t->y);
+	const struct motion_filter_chain *chain = &tp->filter;
+	struct touch *t;
+	bool touching = false;
+
+	touchpad_for_each_touch(tp, t) {
+		if (t->state != TOUCH_NONE) {
+			touching = true;
+			break;
+		}
+	}
+	touchpad_frame_period_update(tp, touching);
+
+	touchpad_for_each_touch(tp, t) {
+		int last;
+
+		if (t->state == TOUCH_NONE)
+			continue;
+
+		if (tp->config.rest_frames && touchpad_touch_rests(tp, t)) {
+			t->dirty = false;
+			t->dx = 0;
+			t->dy = 0;
+			t->vx = 0;
+			t->vy = 0;
+			continue;
+		}
+
+		if (t->state == TOUCH_BEGIN)
+			touchpad_history_push(t, t->x, t->y, tp->ms);
+
+		if (t->dirty)
+			for (int i = 0; i < chain->npositions; i++)
+				chain->stages[i]->process(tp, t);
+
+		last = touchpad_history_get_last(t);
+		t->dx = t->x - touchpad_history_x(t, last);
+		t->dy = t->y - touchpad_history_y(t, last);
+		t->vx = 0;
+		t->vy = 0;
+
+		for (int i = chain->npositions; i < chain->nstages; i++)
+			chain->stages[i]->process(tp, t);
+	}
+}
+
+void
+touchpad_motion_to_delta(struct touch *t, int *dx_out, int *dy_out)
+{
+	*dx_out = t->dx;
+	*dy_out = t->dy;
 }
 
 void
@@ -113,27 +684,68 @@ touchpad_history_reset(struct touchpad *tp, struct touch *t)
 	t->history.index = 0;
 	t->history.valid = 0;
 	t->history.size = tp->config.motion_history_size;
+	t->dx = 0;
+	t->dy = 0;
+	t->vx = 0;
+	t->vy = 0;
+
+	for (int i = 0; i < tp->filter.nstages; i++)
+		if (tp->filter.stages[i]->reset)
+			tp->filter.stages[i]->reset(tp, t);
+}
+
+static inline int16_t
+history_offset(int value, int origin)
+{
+	int offset = value - origin;
+
+	/* A touch would have to move further than any touchpad is wide
+	 * to hit this */
+	return max(INT16_MIN, min(offset, INT16_MAX));
 }
 
 void
 touchpad_history_push(struct touch *t, int x, int y, unsigned int millis)
 {
 	int index = t->history.index;
+	unsigned int offset;
 
-	t->history.points[index].x = x;
-	t->history.points[index].y = y;
-	t->history.points[index].millis = millis;
+	if (t->history.valid == 0) {
+		t->history.origin_x = x;
+		t->history.origin_y = y;
+		t->history.base_millis = millis;
+	}
+
+	/* Move the time base forward if the offset doesn't fit anymore.
+	 * Anything that drops below the new base is too old to matter */
+	offset = millis - t->history.base_millis;
+	if (offset > INT16_MAX) {
+		unsigned int shift = offset - INT16_MAX/2;
+
+		for (int i = 0; i < t->history.size; i++)
+			t->history.millis[i] = max((int)t->history.millis[i] - (int)shift, 0);
+		t->history.base_millis += shift;
+		offset -= shift;
+	}
+
+	t->history.x[index] = history_offset(x, t->history.origin_x);
+	t->history.y[index] = history_offset(y, t->history.origin_y);
+	t->history.millis[index] = offset;
 	t->history.valid = min(t->history.valid + 1, t->history.size);
 	t->history.index = (t->history.index + 1) % t->history.size;
 }
 
-struct touch_history_point *
+int
 touchpad_history_get_last(struct touch *t)
 {
 	return touchpad_history_get(t, -1);
 }
 
-struct touch_history_point *
+/**
+ * @return the index into the history arrays for the entry pushed when
+ * frames ago, or -1 if there is no such entry
+ */
+int
 touchpad_history_get(struct touch *t, int when)
 {
 	int index;
@@ -142,5 +754,5 @@ touchpad_history_get(struct touch *t, int when)
 	when = abs(when);
 	index = (((int)t->history.index - when) + t->history.size) % t->history.size;
 
-	return when > t->history.valid ? NULL : &t->history.points[index];
+	return when > t->history.valid ? -1 : index;
 }
@@ -0,0 +1,555 @@
+/*
+ * Copyright © 2013 Red Hat, Inc.
+ *
+ * Permission to use, copy, modify, distribute, and sell this software
+ * and its documentation for any purpose is hereby granted without
+ * fee, provided that the above copyright notice appear in all copies
+ * and that both that copyright notice and this permission notice
+ * appear in supporting documentation, and that the name of Red Hat
+ * not be used in advertising or publicity pertaining to distribution
+ * of the software without specific, written prior permission.  Red
+ * Hat makes no representations about the suitability of this software
+ * for any purpose.  It is provided "as is" without express or implied
+ * warranty.
+ *
+ * THE AUTHORS DISCLAIM ALL WARRANTIES WITH REGARD TO THIS SOFTWARE,
+ * INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS, IN
+ * NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY SPECIAL, INDIRECT OR
+ * CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS
+ * OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT,
+ * NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+ * CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "touchpad-int.h"
+#include "touchpad-config.h"
+
+/* Pinch and rotate only start once the fingers moved in opposite
+ * directions, each by at least GESTURE_MIN_MOVE, and the distance or the
+ * angle between them changed by the threshold */
+#define GESTURE_MIN_MOVE 1 /* mm */
+#define GESTURE_PINCH_THRESHOLD 3 /* mm */
+#define GESTURE_ROTATE_THRESHOLD 8 /* degrees */
+/* A swipe begins once the centroid moved this far */
+#define GESTURE_SWIPE_THRESHOLD 3 /* mm */
+
+/* angles are in 1/256 degrees */
+#define DEGREES(d) ((d) * 256)
+
+#define ATAN_LUT_SIZE 33
+
+/* atan(i/32) for i in 0..32, in 1/256 degrees */
+static const uint16_t atan_lut[ATAN_LUT_SIZE] = {
+	0, 458, 916, 1371, 1824, 2273, 2719, 3159,
+	3593, 4021, 4443, 4856, 5262, 5660, 6049, 6429,
+	6801, 7163, 7516, 7859, 8193, 8518, 8834, 9141,
+	9439, 9728, 10008, 10280, 10544, 10799, 11047, 11287,
+	11520,
+};
+
+/**
+ * @return atan(num/den) for 0 <= num <= den, in 1/256 degrees,
+ * interpolated between the table entries
+ */
+static int
+atan_ratio(int num, int den)
+{
+	int pos = (int64_t)num * (ATAN_LUT_SIZE - 1) * 256/den;
+	int i = pos/256, frac = pos % 256;
+
+	if (i >= ATAN_LUT_SIZE - 1)
+		return atan_lut[ATAN_LUT_SIZE - 1];
+
+	return atan_lut[i] + (atan_lut[i + 1] - atan_lut[i]) * frac/256;
+}
+
+/**
+ * @return the angle of (x, y) in 1/256 degrees, 0 to 360° exclusive.
+ * The y axis points down, so the angle goes clockwise.
+ */
+static int
+gesture_atan2(int y, int x)
+{
+	int ax = abs(x), ay = abs(y);
+	int angle;
+
+	if (ax == 0 && ay == 0)
+		return 0;
+
+	if (ay <= ax)
+		angle = atan_ratio(ay, ax);
+	else
+		angle = DEGREES(90) - atan_ratio(ax, ay);
+
+	if (x < 0)
+		angle = DEGREES(180) - angle;
+	if (y < 0)
+		angle = DEGREES(360) - angle;
+
+	return angle % DEGREES(360);
+}
+
+/**
+ * @return the difference a - b wrapped into -180° to 180°
+ */
+static int
+angle_diff(int a, int b)
+{
+	int d = (a - b) % DEGREES(360);
+
+	if (d >= DEGREES(180))
+		d -= DEGREES(360);
+	else if (d < -DEGREES(180))
+		d += DEGREES(360);
+
+	return d;
+}
+
+static uint32_t
+isqrt(uint64_t v)
+{
+	uint64_t res = 0, bit = (uint64_t)1 << 62;
+
+	while (bit > v)
+		bit >>= 2;
+
+	while (bit) {
+		if (v >= res + bit) {
+			v -= res + bit;
+			res = (res >> 1) + bit;
+		} else {
+			res >>= 1;
+		}
+		bit >>= 2;
+	}
+
+	return res;
+}
+
+/**
+ * Find the two fingers of a two-finger gesture. Fake touches have no
+ * position of their own and are never one of them.
+ *
+ * @return true if there are exactly two fingers down
+ */
+static bool
+gesture_touches(struct touchpad *tp, struct touch **t0, struct touch **t1)
+{
+	struct touch *t;
+
+	*t0 = NULL;
+	*t1 = NULL;
+
+	if (tp->fingers_down != 2)
+		return false;
+
+	touchpad_for_each_touch(tp, t) {
+		if ((t->state != TOUCH_BEGIN && t->state != TOUCH_UPDATE) ||
+		    t->fake || t->thumb_state != THUMB_STATE_NO)
+			continue;
+
+		if (!*t0)
+			*t0 = t;
+		else if (!*t1)
+			*t1 = t;
+	}
+
+	return *t1 != NULL;
+}
+
+/**
+ * The vector from t0 to t1, with y in x units so distances and angles
+ * are the same as on the touchpad surface
+ */
+static void
+gesture_vector(struct touchpad *tp, struct touch *t0, struct touch *t1,
+	       int *x, int *y)
+{
+	*x = t1->x - t0->x;
+	*y = touchpad_geometry_y_to_x(tp, t1->y - t0->y);
+}
+
+static inline int64_t
+squared(int x, int y)
+{
+	return (int64_t)x * x + (int64_t)y * y;
+}
+
+static void
+gesture_start(struct touchpad *tp, struct touch *t0, struct touch *t1)
+{
+	struct gesture *g = &tp->gesture;
+	int threshold = GESTURE_PINCH_THRESHOLD * tp->geometry.xres;
+	int x, y, d;
+
+	gesture_vector(tp, t0, t1, &x, &y);
+	d = isqrt(squared(x, y));
+
+	g->state = GESTURE_STATE_UNDECIDED;
+	g->start[0].x = t0->x;
+	g->start[0].y = t0->y;
+	g->start[1].x = t1->x;
+	g->start[1].y = t1->y;
+	g->d2_min = squared(max(d - threshold, 0), 0);
+	g->d2_max = squared(d + threshold, 0);
+	g->d2 = squared(x, y);
+	g->angle = gesture_atan2(y, x);
+}
+
+/**
+ * @return true if both fingers moved since the gesture started, in
+ * opposite directions. Moving both fingers the same way is a scroll,
+ * holding one finger still is a scroll too.
+ */
+static bool
+gesture_fingers_opposed(struct touchpad *tp, struct touch *t0, struct touch *t1)
+{
+	struct gesture *g = &tp->gesture;
+	int64_t min_move = squared(GESTURE_MIN_MOVE * tp->geometry.xres, 0);
+	int x0 = t0->x - g->start[0].x,
+	    y0 = touchpad_geometry_y_to_x(tp, t0->y - g->start[0].y),
+	    x1 = t1->x - g->start[1].x,
+	    y1 = touchpad_geometry_y_to_x(tp, t1->y - g->start[1].y);
+
+	if (squared(x0, y0) < min_move || squared(x1, y1) < min_move)
+		return false;
+
+	return (int64_t)x0 * x1 + (int64_t)y0 * y1 < 0;
+}
+
+/**
+ * Send the pinch and rotate events for the current finger positions.
+ * Both are relative to the last position sent, and only sent once the
+ * scale changed by 1% or the angle by 1°. The last position is updated
+ * by what was sent rather than to the current position, so the rounding
+ * doesn't add up.
+ */
+static void
+gesture_post_events(struct touchpad *tp, void *userdata, int x, int y)
+{
+	struct gesture *g = &tp->gesture;
+	int64_t d2 = squared(x, y);
+	int delta;
+
+	if ((touchpad_gesture_enabled(tp) & TOUCHPAD_GESTURE_PINCH) && g->d2 > 0 &&
+	    (d2 * 100 * 100 >= g->d2 * 101 * 101 ||
+	     d2 * 100 * 100 <= g->d2 * 99 * 99)) {
+		int scale = isqrt(d2 * 100 * 100/g->d2);
+
+		tp->interface.pinch(tp, userdata, scale);
+		g->d2 = g->d2 * scale * scale/(100 * 100);
+	}
+
+	delta = angle_diff(gesture_atan2(y, x), g->angle);
+	if ((touchpad_gesture_enabled(tp) & TOUCHPAD_GESTURE_ROTATE) &&
+	    abs(delta) >= DEGREES(1)) {
+		int degrees = delta/DEGREES(1);
+
+		tp->interface.rotate(tp, userdata, degrees);
+		g->angle = (g->angle + DEGREES(degrees) + DEGREES(360)) % DEGREES(360);
+	}
+}
+
+static void
+swipe_end(struct touchpad *tp, void *userdata)
+{
+	struct gesture *g = &tp->gesture;
+
+	if (g->swipe.active)
+		tp->interface.swipe_end(tp, userdata, g->swipe.fingers);
+
+	g->swipe.fingers = 0;
+	g->swipe.active = false;
+}
+
+/**
+ * Swipes with three or more fingers. The swipe moves with the centroid
+ * of the touches, i.e. by the average of this frame's deltas. Fake
+ * touches have no position of their own and don't count towards the
+ * average, so on devices that track fewer touches than fingers the
+ * swipe moves with the touches they do track.
+ *
+ * @return 1 if three or more fingers are down, 0 otherwise
+ */
+static int
+touchpad_gesture_handle_swipe(struct touchpad *tp, void *userdata)
+{
+	struct gesture *g = &tp->gesture;
+	int threshold = GESTURE_SWIPE_THRESHOLD * tp->geometry.xres;
+	struct touch *t;
+	int dx = 0, dy = 0, n = 0;
+
+	if (!(touchpad_gesture_enabled(tp) & TOUCHPAD_GESTURE_SWIPE) ||
+	    tp->fingers_down < 3 || tp->buttons.state != 0) {
+		swipe_end(tp, userdata);
+		return 0;
+	}
+
+	if (tp->fingers_down != g->swipe.fingers) {
+		swipe_end(tp, userdata);
+		g->swipe.fingers = tp->fingers_down;
+		g->swipe.dx = 0;
+		g->swipe.dy = 0;
+		g->swipe.remainder_x = 0;
+		g->swipe.remainder_y = 0;
+	}
+
+	touchpad_for_each_touch(tp, t) {
+		if (t->state != TOUCH_UPDATE || t->fake ||
+		    t->thumb_state != THUMB_STATE_NO)
+			continue;
+
+		dx += t->dx;
+		dy += t->dy;
+		n++;
+	}
+
+	if (n == 0)
+		return 1;
+
+	/* carry the remainder over so slow swipes don't get lost */
+	dx += g->swipe.remainder_x;
+	dy += g->swipe.remainder_y;
+	g->swipe.remainder_x = dx % n;
+	g->swipe.remainder_y = dy % n;
+	dx /= n;
+	dy /= n;
+
+	if (!g->swipe.active) {
+		g->swipe.dx += dx;
+		g->swipe.dy += dy;
+
+		if (squared(g->swipe.dx, touchpad_geometry_y_to_x(tp, g->swipe.dy)) <
+		    squared(threshold, 0))
+			return 1;
+
+		g->swipe.active = true;
+		tp->interface.swipe_begin(tp, userdata, g->swipe.fingers);
+		dx = g->swipe.dx;
+		dy = g->swipe.dy;
+	}
+
+	if (dx || dy)
+		tp->interface.swipe_update(tp, userdata, g->swipe.fingers, dx, dy);
+
+	return 1;
+}
+
+/**
+ * Multi-finger gestures: swipes with three or more fingers, see
+ * touchpad_gesture_handle_swipe(), and two-finger pinch and rotate.
+ *
+ * A pinch or rotation starts when the second finger comes down and is
+ * undecided until either a two-finger scroll starts or the fingers move
+ * apart, together or around each other by more than the thresholds.
+ * While the fingers move in opposite directions, scrolling is held off
+ * so it doesn't start during a pinch.
+ *
+ * Swipes and pinches are only looked at if the frame is a candidate for
+ * them, see touchpad_frame_classify().
+ *
+ * @return 1 if the gesture consumed the frame, 0 otherwise
+ */
+int
+touchpad_gesture_handle_state(struct touchpad *tp, void *userdata)
+{
+	struct gesture *g = &tp->gesture;
+	struct touch *t0, *t1;
+	int x, y;
+
+	/* a swipe supersedes an undecided pinch */
+	if ((tp->frame.candidates & FRAME_SWIPE) &&
+	    touchpad_gesture_handle_swipe(tp, userdata)) {
+		g->state = GESTURE_STATE_NONE;
+		return 1;
+	}
+
+	if (!(tp->frame.candidates & FRAME_PINCH))
+		return 0;
+
+	if (!(touchpad_gesture_enabled(tp) & (TOUCHPAD_GESTURE_PINCH|TOUCHPAD_GESTURE_ROTATE)) ||
+	    tp->semi_mt.enabled || tp->buttons.state != 0 ||
+	    !gesture_touches(tp, &t0, &t1)) {
+		g->state = GESTURE_STATE_NONE;
+		return 0;
+	}
+
+	switch (g->state) {
+		case GESTURE_STATE_NONE:
+			gesture_start(tp, t0, t1);
+			return 0;
+		case GESTURE_STATE_UNDECIDED:
+			if (!gesture_fingers_opposed(tp, t0, t1))
+				return 0;
+
+			gesture_vector(tp, t0, t1, &x, &y);
+			if (squared(x, y) > g->d2_min && squared(x, y) < g->d2_max &&
+			    abs(angle_diff(gesture_atan2(y, x), g->angle)) < DEGREES(GESTURE_ROTATE_THRESHOLD))
+				return 1;
+
+			g->state = GESTURE_STATE_ACTIVE;
+			gesture_post_events(tp, userdata, x, y);
+			return 1;
+		case GESTURE_STATE_ACTIVE:
+			gesture_vector(tp, t0, t1, &x, &y);
+			gesture_post_events(tp, userdata, x, y);
+			return 1;
+	}
+
+	return 0;
+}
+
+static void
+hold_end(struct touchpad *tp, void *userdata, bool cancelled,
+	 enum hold_state state)
+{
+	struct gesture *g = &tp->gesture;
+
+	if (g->hold.state == HOLD_STATE_ACTIVE)
+		tp->interface.hold_end(tp, userdata, cancelled);
+
+	g->hold.state = state;
+	g->hold.timeout = 0;
+}
+
+/**
+ * Drop an undecided pinch, swipe or hold, another recognizer has taken
+ * over the fingers.
+ */
+void
+touchpad_gesture_cancel(struct touchpad *tp, void *userdata)
+{
+	tp->gesture.state = GESTURE_STATE_NONE;
+	swipe_end(tp, userdata);
+	if (tp->gesture.hold.state != HOLD_STATE_NONE)
+		hold_end(tp, userdata, true, HOLD_STATE_DONE);
+	touchpad_symbol_cancel(tp);
+}
+
+/**
+ * @return the one finger down in a one-finger frame, or NULL
+ */
+struct touch *
+touchpad_gesture_single_touch(struct touchpad *tp)
+{
+	struct touch *t;
+
+	touchpad_for_each_touch(tp, t) {
+		if ((t->state == TOUCH_BEGIN || t->state == TOUCH_UPDATE) &&
+		    t->thumb_state == THUMB_STATE_NO)
+			return t;
+	}
+
+	log_bug(tp, true, "one finger down but no touch\n");
+	return NULL;
+}
+
+/**
+ * A single finger resting. The timer starts when the number of fingers
+ * becomes one, the hold begins when the timer fires unless the finger
+ * moved further than the tap movement threshold since. Once a hold
+ * ended or was cancelled, the finger can't start another one.
+ *
+ * @return 1 while the hold is active, 0 otherwise
+ */
+int
+touchpad_gesture_handle_hold(struct touchpad *tp, void *userdata)
+{
+	struct gesture *g = &tp->gesture;
+	int64_t threshold = tp->tap.move_threshold;
+	struct touch *touch;
+	int dx, dy;
+
+	if (!(touchpad_gesture_enabled(tp) & TOUCHPAD_GESTURE_HOLD) ||
+	    tp->frame.fingers != 1) {
+		hold_end(tp, userdata, tp->frame.fingers != 0, HOLD_STATE_NONE);
+		return 0;
+	}
+
+	if (tp->buttons.state != 0) {
+		hold_end(tp, userdata, true, HOLD_STATE_DONE);
+		return 0;
+	}
+
+	/* the finger that ended the hold may have been lifted while a scroll
+	 * owned the frames, a new finger starts over */
+	if (g->hold.state == HOLD_STATE_DONE && tp->frame.began)
+		g->hold.state = HOLD_STATE_NONE;
+
+	if (g->hold.state == HOLD_STATE_DONE)
+		return 0;
+
+	touch = touchpad_gesture_single_touch(tp);
+	if (touch == NULL)
+		return 0;
+
+	switch (g->hold.state) {
+		case HOLD_STATE_NONE:
+			g->hold.state = HOLD_STATE_PENDING;
+			g->hold.x = touch->x;
+			g->hold.y = touch->y;
+			g->hold.timeout = tp->ms + g->config.hold_timeout;
+			touchpad_request_timer(tp, userdata, tp->ms, g->config.hold_timeout);
+			return 0;
+		case HOLD_STATE_PENDING:
+		case HOLD_STATE_ACTIVE:
+			dx = touch->x - g->hold.x;
+			dy = touchpad_geometry_y_to_x(tp, touch->y - g->hold.y);
+			if ((int64_t)dx * dx + (int64_t)dy * dy > threshold * threshold) {
+				hold_end(tp, userdata, true, HOLD_STATE_DONE);
+				return 0;
+			}
+			return g->hold.state == HOLD_STATE_ACTIVE;
+		case HOLD_STATE_DONE:
+			break;
+	}
+
+	return 0;
+}
+
+unsigned int
+touchpad_gesture_handle_timeout(struct touchpad *tp, unsigned int now, void *userdata)
+{
+	struct gesture *g = &tp->gesture;
+
+	if (g->hold.state != HOLD_STATE_PENDING)
+		return 0;
+
+	if (g->hold.timeout > now)
+		return g->hold.timeout;
+
+	g->hold.state = HOLD_STATE_ACTIVE;
+	g->hold.timeout = 0;
+	touchpad_symbol_cancel(tp);
+	tp->interface.hold_begin(tp, userdata);
+
+	return 0;
+}
+
+/**
+ * @return the configured gestures the interface has the callbacks for
+ */
+unsigned int
+touchpad_gesture_enabled(const struct touchpad *tp)
+{
+	const struct touchpad_interface *interface = &tp->interface;
+	unsigned int gestures = tp->gesture.config.gestures;
+
+	if (!interface->pinch)
+		gestures &= ~TOUCHPAD_GESTURE_PINCH;
+	if (!interface->rotate)
+		gestures &= ~TOUCHPAD_GESTURE_ROTATE;
+	if (!interface->swipe_begin || !interface->swipe_update ||
+	    !interface->swipe_end)
+		gestures &= ~TOUCHPAD_GESTURE_SWIPE;
+	if (!interface->hold_begin || !interface->hold_end)
+		gestures &= ~TOUCHPAD_GESTURE_HOLD;
+	if (!interface->symbol)
+		gestures &= ~TOUCHPAD_GESTURE_SYMBOL;
+
+	return gestures;
+}
@@ -34,6 +34,7 @@
 #include <stdlib.h>
 #include <linux/input.h>
 #include "touchpad.h"
+#include "touchpad-config.h"
 #include "touchpad-util.h"
 
 void touchpad_error_log(const char *msg, ...);
@@ -44,7 +45,7 @@ void touchpad_error_log(const char *msg, ...);
 
 #define MAX_TOUCHPOINTS 10 /* update when mutants are commonplace */
 #define MAX_MOTION_HISTORY_SIZE 10
-#define MAX_TAP_EVENTS 10
+#define FRAME_PERIOD_SAMPLES 5
 
 enum touch_state {
 	TOUCH_NONE = 7,
@@ -53,17 +54,26 @@ enum touch_state {
 	TOUCH_END,
 };
 
-struct touch_history_point {
-	int x;
-	int y;
-	unsigned int millis;
-};
-
+/**
+ * Ring buffer of the last N positions of a touch. Coordinates are stored
+ * as separate arrays rather than an array of points so the windowed sums
+ * in touchpad_motion_update() can run over contiguous memory.
+ *
+ * To keep the touch small, coordinates are stored as 16-bit offsets to
+ * the touch's origin (its first position) and timestamps as 16-bit
+ * offsets to a base timestamp. Timestamps are those of the frame, not of
+ * the last event for this touch. Use the touchpad_history_*() accessors
+ * rather than the raw arrays.
+ */
 struct touch_history {
-	struct touch_history_point points[MAX_MOTION_HISTORY_SIZE];
-	unsigned int index;
-	size_t valid;
-	size_t size;
+	int origin_x, origin_y;
+	unsigned int base_millis;
+	int16_t x[MAX_MOTION_HISTORY_SIZE];
+	int16_t y[MAX_MOTION_HISTORY_SIZE];
+	int16_t millis[MAX_MOTION_HISTORY_SIZE];
+	uint8_t index;
+	uint8_t valid;
+	uint8_t size;
 };
 
 enum button_state {
@@ -92,23 +102,48 @@ enum button_event {
 };
 
 
+enum thumb_state {
+	THUMB_STATE_NO = 50,
+	THUMB_STATE_NEW, /**< became a thumb in this frame */
+	THUMB_STATE_YES,
+};
+
+enum scroll_edge {
+	SCROLL_EDGE_NONE = 60,
+	SCROLL_EDGE_RIGHT,
+	SCROLL_EDGE_BOTTOM,
+};
+
+/**
+ * Per-touch state. This is walked for every touch in every frame, so keep
+ * it compact: enums and flags are bitfields, the history is 16 bit. See
+ * the size check in touchpad_alloc().
+ */
 struct touch {
-	bool dirty;
-	bool pointer; /**< is this the pointer-moving touchpoint? */
-	bool pinned; /**< touch is pinned from phys. button press, movement is ignored */
-	bool fake; /**< touch is a fake touch from BTN_TOOL_*TAP */
+	enum touch_state state:8;
+	enum button_state button_state:8; /**< state for softbuttons */
+	enum thumb_state thumb_state:8; /**< see touchpad_button_detect_thumbs() */
+	enum scroll_edge scroll_edge:8; /**< edge zone the touch began in, see touchpad_scroll_detect_edges() */
+	bool dirty:1;
+	bool pointer:1; /**< is this the pointer-moving touchpoint? */
+	bool pinned:1; /**< touch is pinned from phys. button press, movement is ignored */
+	bool fake:1; /**< touch is a fake touch from BTN_TOOL_*TAP */
+	bool hovering:1; /**< contact is down but not qualified, see touchpad_qualify_touches() */
+	bool resting:1; /**< touch hasn't moved for a while, see touchpad_motion_update() */
 
-	enum touch_state state;
-	int millis;
 	int x, y;
+	int dx, dy; /**< delta for this frame, see touchpad_motion_update() */
+	int vx, vy; /**< velocity in units/s, 0 if unknown */
+	int pressure, major; /**< ABS_MT_PRESSURE, ABS_MT_TOUCH_MAJOR */
 
 	unsigned int number;
-	struct touch_history history;
-
-	enum button_state button_state; /**< state for softbuttons */
 	unsigned int button_timeout;
+
+	struct touch_history history;
 };
 
+#define TOUCH_MAX_SIZE (2 * 64) /* two cache lines */
+
 enum tap_state {
 	TAP_STATE_IDLE = 4,
 	TAP_STATE_TOUCH,
@@ -136,31 +171,157 @@ enum tap_event {
 struct tap_config {
 	bool enabled;
 	unsigned int timeout_period;
-	unsigned int move_threshold;
+	unsigned int move_threshold; /**< in µm */
 };
 
 struct tap {
 	struct tap_config config;
+	int move_threshold; /**< in x units */
 	unsigned int timeout;
 	enum tap_state state;
-	enum tap_event events[MAX_TAP_EVENTS];
+};
+
+#define ACCEL_LUT_SIZE 64
+
+struct accel_config {
+	enum touchpad_accel_profile profile;
+	int min_factor; /**< in % */
+	int max_factor; /**< in % */
+	int threshold; /**< in mm/s */
+	int max_speed; /**< in mm/s */
+};
+
+/**
+ * An acceleration curve, precalculated at config time so applying it is
+ * a table lookup.
+ */
+struct accel_curve {
+	int max_speed; /**< in x units/s, speed of the last entry */
+	uint16_t gain[ACCEL_LUT_SIZE]; /**< in 1/256 */
+};
+
+struct accel {
+	struct accel_config config;
+	struct accel_curve curve;
+	int remainder_x, remainder_y; /**< in 1/256 units */
 };
 
 enum scroll_state {
 	SCROLL_STATE_NONE = 9,
 	SCROLL_STATE_SCROLLING,
+	SCROLL_STATE_KINETIC, /**< fingers lifted, scrolling on from the timer */
 };
 
 struct scroll_config {
 	enum touchpad_scroll_methods methods;
-	int hdelta;
-	int vdelta;
+	int hdelta; /**< in µm */
+	int vdelta; /**< in µm */
+	int edge_size; /**< in µm */
+	bool kinetic;
+	int kinetic_friction; /**< in % of the speed lost every 10ms */
+	bool two_axis;
+	int axis_lock; /**< in degrees, 0 to disable */
+	struct accel_config accel; /**< min_factor is always 100% */
 };
 
 struct scroll {
 	struct scroll_config config;
+	int hdist, vdist; /**< hdelta and vdelta in device units */
+	int edge_right, edge_bottom; /**< edge zones start past these */
 	enum scroll_state state;
 	enum touchpad_scroll_direction direction;
+	enum touchpad_scroll_methods method; /**< the method scrolling, both two-finger methods for a two-axis scroll */
+	double axis_lock_slope; /**< tan(axis_lock) */
+	double hires_remainder_x, hires_remainder_y; /**< in high-resolution units */
+	struct accel_curve accel_curve;
+
+	struct {
+		double speed_x, speed_y; /**< in scroll units/s */
+		unsigned int last; /**< time of the last tick */
+		unsigned int timeout;
+	} kinetic;
+};
+
+enum gesture_state {
+	GESTURE_STATE_NONE = 70,
+	GESTURE_STATE_UNDECIDED, /**< two fingers down, not moving apart yet */
+	GESTURE_STATE_ACTIVE,
+};
+
+struct gesture_config {
+	unsigned int gestures; /**< enum touchpad_gestures */
+	unsigned int hold_timeout; /**< in ms */
+	unsigned int symbol_threshold; /**< in % of the symbol size */
+};
+
+enum hold_state {
+	HOLD_STATE_NONE = 90,
+	HOLD_STATE_PENDING, /**< one finger down, timer running */
+	HOLD_STATE_ACTIVE, /**< hold_begin was sent */
+	HOLD_STATE_DONE, /**< ended or cancelled, until the fingers change */
+};
+
+struct gesture {
+	struct gesture_config config;
+	enum gesture_state state;
+	struct {
+		int x, y;
+	} start[2]; /**< finger positions when the gesture started */
+	int64_t d2_min, d2_max; /**< squared distances that start a pinch */
+	int64_t d2; /**< squared distance last sent, y in x units */
+	int angle; /**< angle last sent, in 1/256 degrees */
+
+	struct {
+		int fingers; /**< 0 if no swipe */
+		bool active; /**< swipe_begin was sent */
+		int dx, dy; /**< movement before the swipe began */
+		int remainder_x, remainder_y; /**< of the centroid division */
+	} swipe;
+
+	struct {
+		enum hold_state state;
+		int x, y; /**< where the finger was when the timer started */
+		unsigned int timeout;
+	} hold;
+};
+
+#define SYMBOL_POINTS 32
+#define SYMBOL_MAX_PATH 128
+#define SYMBOL_SCALE 1024
+#define SYMBOL_MIN_SIZE 10 /* mm */
+
+/**
+ * A stroke or a template, resampled to SYMBOL_POINTS points evenly spaced
+ * along its path, centered and scaled so its larger side spans
+ * -SYMBOL_SCALE to SYMBOL_SCALE. The coordinates are separate arrays of
+ * 16-bit values so the distance in touchpad_symbol_match() is a
+ * branch-free loop over contiguous memory that the compiler vectorizes.
+ */
+struct symbol_shape {
+	int16_t x[SYMBOL_POINTS];
+	int16_t y[SYMBOL_POINTS];
+};
+
+struct symbol_template {
+	int id;
+	struct symbol_shape shape;
+};
+
+enum symbol_state {
+	SYMBOL_STATE_NONE = 100,
+	SYMBOL_STATE_RECORDING, /**< one finger down, path being recorded */
+	SYMBOL_STATE_DONE, /**< cancelled, until the finger is lifted */
+};
+
+struct symbol {
+	struct symbol_template *templates;
+	int ntemplates;
+
+	enum symbol_state state;
+	int spacing; /**< minimum distance between path points, x units */
+	int npoints;
+	int x[SYMBOL_MAX_PATH], y[SYMBOL_MAX_PATH]; /**< y in x units */
+	int last_x, last_y; /**< the finger's latest position */
 };
 
 struct button_config {
@@ -168,6 +329,8 @@ struct button_config {
 	int right[2]; /* left, right */
 	unsigned int leave_timeout;
 	unsigned int enter_timeout;
+	unsigned int thumb_timeout; /**< in ms */
+	int thumb_move_threshold; /**< in µm */
 };
 
 struct buttons {
@@ -181,6 +344,8 @@ struct buttons {
 
 	unsigned int timeout;
 
+	int thumb_move_threshold; /**< in x units */
+
 	/**
 	 * Process the current touchpad state, different for clickpads and
 	 * traditional touchpads.
@@ -188,6 +353,41 @@ struct buttons {
 	int (*handle_state)(struct touchpad *tp, void *userdata);
 	int (*handle_timeout)(struct touchpad *tp, unsigned int now, void *userdata);
 	bool (*select_pointer_touch)(struct touchpad *tp, struct touch *t);
+	/**
+	 * Optional, classify touches as thumbs before anything else looks
+	 * at the frame.
+	 */
+	void (*detect_thumbs)(struct touchpad *tp);
+	/**
+	 * Optional, true if the touch is in the software button area.
+	 * Touchpads with physical buttons have none.
+	 */
+	bool (*in_button_area)(struct touchpad *tp, struct touch *t);
+};
+
+/**
+ * Semi-MT touchpads report the corners of the bounding box of all fingers
+ * in the first two slots rather than the fingers themselves, see
+ * touchpad_semi_mt_update_abs_state().
+ */
+struct semi_mt {
+	bool enabled;
+	int x[2], y[2]; /**< corners of the bounding box */
+	int nfingers; /**< fingers in the previous frame */
+};
+
+/**
+ * Device units for the touch qualification, see touchpad_qualify_touches().
+ */
+struct qualify {
+	bool enabled;
+	bool mt_pressure; /**< per-touch pressure, otherwise ABS_PRESSURE */
+	int pressure_min, pressure_max; /**< range of the pressure axis, empty if none */
+	int pressure; /**< last ABS_PRESSURE */
+	int pressure_high, pressure_low; /**< 0 if disabled */
+	int major_min, major_max; /**< range of ABS_MT_TOUCH_MAJOR, empty if none */
+	int major_res; /**< of ABS_MT_TOUCH_MAJOR in units/mm, 0 if unknown */
+	int palm_major; /**< 0 if disabled */
 };
 
 enum event_types {
@@ -197,25 +397,169 @@ enum event_types {
 	EVENT_MOTION = 0x4,
 };
 
+/**
+ * The physical size of the touchpad, read once when the device is opened.
+ * Length thresholds are configured in µm and converted to device units
+ * with this whenever they or the geometry change, see
+ * touchpad_config_apply_geometry().
+ *
+ * Many touchpads have a different resolution on each axis, so the same
+ * distance in device units is a shorter movement on one axis than on the
+ * other.
+ */
+struct touchpad_geometry {
+	int minx, maxx;
+	int miny, maxy;
+	int xres, yres; /**< in units/mm */
+	int width, height; /**< in mm */
+	int anisotropy; /**< yres/xres in 1/256 */
+	bool estimated; /**< the device doesn't announce a resolution */
+};
+
 struct touchpad_config {
 	size_t motion_history_size;
+	unsigned int motion_filters; /**< enum touchpad_motion_filters */
+	int hysteresis_margin; /**< in µm */
+	int adaptive_min_cutoff; /**< in mHz */
+	int adaptive_beta; /**< in mHz per mm/s */
+	int tracker_alpha; /**< in 1/1000 */
+	int tracker_beta; /**< in 1/1000 */
+	int prediction_time; /**< in ms */
+	int jump_max_speed; /**< in mm/s */
+	int pressure_high, pressure_low; /**< in % of the pressure range */
+	int palm_size; /**< in µm */
+	unsigned int rest_frames;
+};
+
+#define MAX_MOTION_FILTERS 8
+
+enum motion_filter_type {
+	MOTION_FILTER_POSITION = 40, /**< filters t->x/y before the delta */
+	MOTION_FILTER_DELTA, /**< filters t->dx/dy */
 };
 
+/**
+ * A stage in the per-frame motion processing, see touchpad_motion_update().
+ * init and reset are optional.
+ */
+struct motion_filter {
+	const char *name;
+	enum motion_filter_type type;
+	/** called whenever the chain is rebuilt after a config change */
+	void (*init)(struct touchpad *tp);
+	/** called once per frame for each active touch */
+	void (*process)(struct touchpad *tp, struct touch *t);
+	/** called when a touch's history is reset */
+	void (*reset)(struct touchpad *tp, struct touch *t);
+};
+
+/**
+ * Per-touch state of the filter stages. This is kept out of struct touch
+ * since most stages are disabled most of the time, use
+ * touchpad_filter_state() to get a touch's state.
+ */
+struct touch_filter_state {
+	struct {
+		int x, y; /**< where the touch came to rest */
+		unsigned int frames; /**< frames within the margin of x/y */
+	} rest;
+	struct {
+		bool pending; /**< the last position was discarded */
+		int x, y; /**< the discarded position */
+	} jump;
+	struct {
+		bool valid;
+		int x, y; /**< filtered position in 1/256 units */
+		int speed_x, speed_y; /**< filtered speed in units/s */
+	} adaptive;
+	struct {
+		bool valid;
+		int x, y; /**< estimated position in 1/256 units */
+		int vx, vy; /**< estimated velocity in units/s */
+	} tracker;
+	struct {
+		int offset_x, offset_y; /**< prediction applied, in units */
+		int vx, vy; /**< velocity of the previous frame */
+	} predict;
+};
+
+struct motion_filter_chain {
+	/* position filters first, then delta filters */
+	const struct motion_filter *stages[MAX_MOTION_FILTERS];
+	int nstages;
+	int npositions; /**< number of position filters */
+	int margin_x, margin_y; /**< hysteresis margin in device units */
+	unsigned int jumps; /**< number of positions discarded as jumps */
+
+	struct touch_filter_state touches[MAX_TOUCHPOINTS];
+};
+
+
+/**
+ * Where and when a touch began. Only the classifiers need this, so it's
+ * kept out of struct touch, see touchpad_touch_origin().
+ */
+struct touch_origin {
+	int x, y;
+	unsigned int millis;
+};
+
+/**
+ * What a frame can be, see touchpad_frame_classify()
+ */
+enum frame_candidates {
+	FRAME_POINTER = 0x1,
+	FRAME_SCROLL = 0x2,
+	FRAME_PINCH = 0x4, /**< pinch or rotate */
+	FRAME_SWIPE = 0x8,
+	FRAME_HOLD = 0x10,
+	FRAME_SYMBOL = 0x20, /**< never consumes the frame */
+};
+
+/**
+ * Metrics of the current frame, collected once for all recognizers, and
+ * the device's frame period
+ */
+struct frame {
+	int fingers; /**< fingers down, excluding thumbs */
+	int moving; /**< touches that moved, excluding thumbs and resting touches */
+	int began, ended; /**< touches that began or ended */
+	int edge; /**< touches in an edge scroll zone */
+	unsigned int candidates; /**< enum frame_candidates */
+	bool scrolling; /**< the scroll owned the frame */
+
+	/* the device's frame interval, the median of the most recent
+	   intervals between frames with a touch down */
+	int dt[FRAME_PERIOD_SAMPLES]; /**< in ms */
+	int dt_index;
+	int period; /**< in ms, 0 until known */
+	unsigned int last_ms; /**< of the previous frame with a touch down */
+};
 
 struct touchpad {
     struct libevdev *dev;
-    int fingers_down;		/* number of fingers down */
+    int fingers_down;		/* number of fingers down, excluding thumbs */
+    int thumbs_down;		/* number of thumbs down */
     int slot;			/* current slot */
 
     int maxtouches;		/* from ABS_MT_SLOT(max) */
     int ntouches;		/* maxtouches + triple/quad if applicable */
     struct touch touches[MAX_TOUCHPOINTS];
+    struct touch_origin origins[MAX_TOUCHPOINTS];
 
+    struct touchpad_geometry geometry;
     struct touchpad_config config;
+    struct motion_filter_chain filter;
     struct buttons buttons;
     struct tap tap;
     struct scroll scroll;
-    const struct touchpad_interface *interface;
+    struct gesture gesture;
+    struct symbol symbol;
+    struct frame frame;
+    struct accel accel;
+    struct semi_mt semi_mt;
+    struct qualify qualify;
+    struct touchpad_interface interface; /* copied, see touchpad_set_interface_v2() */
 
     unsigned int ms;		/* ms of last SYN_REPORT */
 
@@ -241,6 +585,34 @@ touchpad_log(struct touchpad *tp,
 #define touchpad_for_each_touch(_tp, _t) \
 	for (int _i = 0; (_t = touchpad_touch(_tp, _i)) && _i < tp->ntouches; _i++)
 
+/**
+ * @return the distance um (in µm) in device units along the x axis
+ */
+static inline int
+touchpad_geometry_x_units(const struct touchpad *tp, int um)
+{
+	return (int64_t)um * tp->geometry.xres/1000;
+}
+
+/**
+ * @return the distance um (in µm) in device units along the y axis
+ */
+static inline int
+touchpad_geometry_y_units(const struct touchpad *tp, int um)
+{
+	return (int64_t)um * tp->geometry.yres/1000;
+}
+
+/**
+ * @return the distance dy in device units along the y axis, converted to
+ * units along the x axis
+ */
+static inline int
+touchpad_geometry_y_to_x(const struct touchpad *tp, int dy)
+{
+	return (int64_t)dy * 256/tp->geometry.anisotropy;
+}
+
 static inline struct touch*
 touchpad_touch(struct touchpad *tp, int index)
 {
@@ -272,6 +644,18 @@ touchpad_pinned_touch(struct touchpad *tp)
 	return NULL;
 }
 
+static inline struct touch_filter_state*
+touchpad_filter_state(struct touchpad *tp, struct touch *t)
+{
+	return &tp->filter.touches[t - tp->touches];
+}
+
+static inline struct touch_origin*
+touchpad_touch_origin(struct touchpad *tp, struct touch *t)
+{
+	return &tp->origins[t - tp->touches];
+}
+
 static inline struct touch*
 touchpad_current_touch(struct touchpad *tp)
 {
@@ -290,28 +674,80 @@ int touchpad_handle_event(struct touchpad *tp,
 			  void *userdata,
 			  const struct input_event *ev);
 
-void touchpad_motion_dejitter(struct touch *t);
+void touchpad_filter_init(struct touchpad *tp);
+void touchpad_motion_update(struct touchpad *tp);
 void touchpad_motion_to_delta(struct touch *t, int *dx, int *dy);
-void touchpad_apply_motion_history(const struct touchpad *tp, struct touch *t);
 void touchpad_history_reset(struct touchpad *tp, struct touch *t);
 void touchpad_history_push(struct touch *t, int x, int y, unsigned int millis);
-struct touch_history_point * touchpad_history_get(struct touch *t, int when);
-struct touch_history_point * touchpad_history_get_last(struct touch *t);
+int touchpad_history_get(struct touch *t, int when);
+int touchpad_history_get_last(struct touch *t);
+
+static inline int
+touchpad_history_x(const struct touch *t, int index)
+{
+	return t->history.origin_x + t->history.x[index];
+}
+
+static inline int
+touchpad_history_y(const struct touch *t, int index)
+{
+	return t->history.origin_y + t->history.y[index];
+}
+
+static inline unsigned int
+touchpad_history_millis(const struct touch *t, int index)
+{
+	return t->history.base_millis + t->history.millis[index];
+}
 int touchpad_tap_handle_state(struct touchpad *tp, void *userdata);
 unsigned int touchpad_tap_handle_timeout(struct touchpad *tp, unsigned int ms, void *userdata);
 int touchpad_scroll_handle_state(struct touchpad *tp, void *userdata);
+void touchpad_scroll_detect_edges(struct touchpad *tp);
+unsigned int touchpad_scroll_handle_timeout(struct touchpad *tp, unsigned int now, void *userdata);
+void touchpad_scroll_accel_init(struct touchpad *tp);
+int touchpad_gesture_handle_state(struct touchpad *tp, void *userdata);
+void touchpad_gesture_cancel(struct touchpad *tp, void *userdata);
+int touchpad_gesture_handle_hold(struct touchpad *tp, void *userdata);
+unsigned int touchpad_gesture_handle_timeout(struct touchpad *tp, unsigned int now, void *userdata);
+unsigned int touchpad_gesture_enabled(const struct touchpad *tp);
+struct touch *touchpad_gesture_single_touch(struct touchpad *tp);
+void touchpad_symbol_handle_state(struct touchpad *tp, void *userdata);
+void touchpad_symbol_cancel(struct touchpad *tp);
+void touchpad_symbol_free(struct touchpad *tp);
+bool touchpad_symbol_shape(const int *x, const int *y, int npoints,
+			   int min_size, struct symbol_shape *shape);
+int touchpad_symbol_match(const struct touchpad *tp, const struct symbol_shape *shape);
 int touchpad_button_handle_state(struct touchpad *tp, void *userdata);
 bool touchpad_button_select_pointer_touch(struct touchpad *tp, struct touch *t);
 int touchpad_button_handle_timeout(struct touchpad *tp, unsigned int now, void *userdata);
+void touchpad_button_detect_thumbs(struct touchpad *tp);
+bool touchpad_button_in_area(struct touchpad *tp, struct touch *t);
 int touchpad_phys_button_handle_state(struct touchpad *tp, void *userdata);
 bool touchpad_phys_button_select_pointer_touch(struct touchpad *tp, struct touch *t);
 int touchpad_phys_button_handle_timeout(struct touchpad *tp, unsigned int now, void *userdata);
 int touchpad_request_timer(struct touchpad *tp, void *userdata, unsigned int now, unsigned int delta);
 
+void touchpad_accel_curve_init(struct accel_curve *curve,
+			       enum touchpad_accel_profile profile,
+			       int min_factor, int max_factor,
+			       int threshold, int max_speed);
+int touchpad_accel_curve_gain(const struct accel_curve *curve, int speed);
+int touchpad_accel_apply_gain(int delta, int gain, int *remainder);
+void touchpad_accel_init(struct touchpad *tp);
+void touchpad_accel_reset(struct touchpad *tp);
+void touchpad_accel_filter(struct touchpad *tp, struct touch *t, int *dx, int *dy);
+int touchpad_accel_touch_speed(struct touchpad *tp, struct touch *t, int dx, int dy);
+
+void touchpad_geometry_set(struct touchpad *tp,
+			   int minx, int maxx, int xres,
+			   int miny, int maxy, int yres);
+
+void touchpad_config_apply_geometry(struct touchpad *tp);
 void touchpad_config_set_dynamic_defaults(struct touchpad *tp);
 void touchpad_config_set_static_defaults(struct touchpad *tp);
 
 int touchpad_mt_update_abs_state(struct touchpad *tp, const struct input_event *ev);
 int touchpad_st_update_abs_state(struct touchpad *tp, const struct input_event *ev);
+int touchpad_semi_mt_update_abs_state(struct touchpad *tp, const struct input_event *ev);
 
 #endif
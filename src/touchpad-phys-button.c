@@ -40,7 +40,7 @@ touchpad_phys_button_handle_state(struct touchpad *tp, void *userdata)
        shift = 0;
        while (current || old) {
                if ((current & 0x1) ^ (old  & 0x1))
-                       tp->interface->button(tp, userdata, BTN_LEFT + shift, !!(current & 0x1));
+                       tp->interface.button(tp, userdata, BTN_LEFT + shift, !!(current & 0x1));
                shift++;
                current >>= 1;
                old >>= 1;
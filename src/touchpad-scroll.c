@@ -28,6 +28,113 @@
 #include <math.h>
 #include "touchpad-int.h"
 
+/* kinetic scrolling ticks at most this often */
+#define KINETIC_INTERVAL 16 /* ms */
+/* kinetic scrolling starts above and stops below these speeds */
+#define KINETIC_START_SPEED 10 /* scroll units/s */
+#define KINETIC_STOP_SPEED 2 /* scroll units/s */
+/* the release speed is measured over this much of the history */
+#define KINETIC_SPEED_WINDOW 60 /* ms */
+
+/* the method of a two-axis scroll */
+#define SCROLL_TWOFINGER_BOTH (TOUCHPAD_SCROLL_TWOFINGER_VERTICAL | \
+			       TOUCHPAD_SCROLL_TWOFINGER_HORIZONTAL)
+
+static inline bool
+touchpad_scroll_two_axis(struct touchpad *tp)
+{
+	return tp->scroll.config.two_axis &&
+	       (tp->scroll.config.methods & SCROLL_TWOFINGER_BOTH) == SCROLL_TWOFINGER_BOTH;
+}
+
+/**
+ * Send a scroll event to the interface, converted to high-resolution
+ * units if the caller wants those. The fraction that doesn't make up a
+ * full high-resolution unit is carried over to the next event on that
+ * axis.
+ */
+static void
+touchpad_scroll_post(struct touchpad *tp, void *userdata,
+		     enum touchpad_scroll_direction direction, double units)
+{
+	double *remainder;
+	int value;
+
+	if (!tp->interface.scroll_hires) {
+		tp->interface.scroll(tp, userdata, direction, units);
+		return;
+	}
+
+	remainder = (direction == TOUCHPAD_SCROLL_VERTICAL) ?
+		    &tp->scroll.hires_remainder_y :
+		    &tp->scroll.hires_remainder_x;
+
+	if (units == 0.0) {
+		*remainder = 0;
+		tp->interface.scroll_hires(tp, userdata, direction, 0);
+		return;
+	}
+
+	units = units * TOUCHPAD_SCROLL_HIRES_UNITS + *remainder;
+	value = units;
+	*remainder = units - value;
+
+	if (value != 0)
+		tp->interface.scroll_hires(tp, userdata, direction, value);
+}
+
+/**
+ * Terminate the scroll, for both axes if it was a two-axis scroll
+ */
+static void
+touchpad_scroll_stop(struct touchpad *tp, void *userdata)
+{
+	tp->scroll.state = SCROLL_STATE_NONE;
+	tp->scroll.kinetic.timeout = 0;
+
+	if (tp->scroll.method == SCROLL_TWOFINGER_BOTH) {
+		touchpad_scroll_post(tp, userdata, TOUCHPAD_SCROLL_VERTICAL, 0);
+		touchpad_scroll_post(tp, userdata, TOUCHPAD_SCROLL_HORIZONTAL, 0);
+	} else {
+		touchpad_scroll_post(tp, userdata, tp->scroll.direction, 0);
+	}
+}
+
+/**
+ * Build the scroll acceleration curve for the current config and
+ * geometry. Like the pointer's, it works in x units/s.
+ */
+void
+touchpad_scroll_accel_init(struct touchpad *tp)
+{
+	const struct accel_config *config = &tp->scroll.config.accel;
+	int xres = tp->geometry.xres;
+
+	touchpad_accel_curve_init(&tp->scroll.accel_curve,
+				  config->profile,
+				  config->min_factor,
+				  config->max_factor,
+				  config->threshold * xres,
+				  config->max_speed * xres);
+}
+
+/**
+ * @return the factor to multiply the scroll units of touch t with,
+ * given its delta dx/dy for this frame
+ */
+static double
+touchpad_scroll_accel_factor(struct touchpad *tp, struct touch *t, int dx, int dy)
+{
+	int speed;
+
+	if (tp->scroll.config.accel.profile == TOUCHPAD_ACCEL_PROFILE_NONE)
+		return 1.0;
+
+	speed = touchpad_accel_touch_speed(tp, t, dx, dy);
+
+	return touchpad_accel_curve_gain(&tp->scroll.accel_curve, speed)/256.0;
+}
+
 static double
 touchpad_scroll_units(struct touchpad *tp, struct touch *t,
 		      enum touchpad_scroll_direction direction)
@@ -40,18 +147,163 @@ touchpad_scroll_units(struct touchpad *tp, struct touch *t,
 	switch(direction) {
 		case TOUCHPAD_SCROLL_VERTICAL:
 			delta = dy;
-			threshold = tp->scroll.config.vdelta;
+			threshold = tp->scroll.vdist;
 			break;
 		case TOUCHPAD_SCROLL_HORIZONTAL:
 			delta = dx;
-			threshold = tp->scroll.config.hdelta;
+			threshold = tp->scroll.hdist;
 			break;
 		default:
 			log_bug(tp, direction, "invalid scroll direction %d\n", direction);
 			return 0;
 	}
 
-	return delta/threshold;
+	return delta/threshold * touchpad_scroll_accel_factor(tp, t, dx, dy);
+}
+
+/**
+ * @return the speed of t in scroll units/s over the last
+ * KINETIC_SPEED_WINDOW ms, or 0 if it didn't move in that time
+ */
+static double
+touchpad_scroll_touch_speed(struct touchpad *tp, struct touch *t,
+			    enum touchpad_scroll_direction direction)
+{
+	int first = -1;
+	int dt;
+
+	for (int i = 1; i <= t->history.valid; i++) {
+		int index = touchpad_history_get(t, i);
+
+		if ((int)(tp->ms - touchpad_history_millis(t, index)) > KINETIC_SPEED_WINDOW)
+			break;
+		first = index;
+	}
+
+	if (first == -1)
+		return 0;
+
+	dt = tp->ms - touchpad_history_millis(t, first);
+	if (dt <= 0)
+		return 0;
+
+	if (direction == TOUCHPAD_SCROLL_VERTICAL)
+		return (t->y - touchpad_history_y(t, first)) * 1000.0/dt/tp->scroll.vdist;
+	else
+		return (t->x - touchpad_history_x(t, first)) * 1000.0/dt/tp->scroll.hdist;
+}
+
+/**
+ * Start kinetic scrolling at the speed of the fastest of the touches
+ * that were scrolling, along the scroll direction or, for a two-axis
+ * scroll, along both axes.
+ *
+ * @return true if kinetic scrolling started, false if it is disabled or
+ * the fingers were too slow
+ */
+static bool
+touchpad_scroll_start_kinetic(struct touchpad *tp, void *userdata)
+{
+	bool both = tp->scroll.method == SCROLL_TWOFINGER_BOTH;
+	struct touch *t;
+	double speed_x = 0, speed_y = 0;
+
+	if (!tp->scroll.config.kinetic)
+		return false;
+
+	touchpad_for_each_touch(tp, t) {
+		double sx = 0, sy = 0;
+
+		if (t->state == TOUCH_NONE || t->thumb_state != THUMB_STATE_NO)
+			continue;
+
+		if (both || tp->scroll.direction == TOUCHPAD_SCROLL_HORIZONTAL)
+			sx = touchpad_scroll_touch_speed(tp, t, TOUCHPAD_SCROLL_HORIZONTAL);
+		if (both || tp->scroll.direction == TOUCHPAD_SCROLL_VERTICAL)
+			sy = touchpad_scroll_touch_speed(tp, t, TOUCHPAD_SCROLL_VERTICAL);
+
+		if (hypot(sx, sy) > hypot(speed_x, speed_y)) {
+			speed_x = sx;
+			speed_y = sy;
+		}
+	}
+
+	/* a fast flick goes on as fast as the fingers scrolled */
+	if (tp->scroll.config.accel.profile != TOUCHPAD_ACCEL_PROFILE_NONE) {
+		int speed = hypot(speed_x * tp->scroll.hdist,
+				  touchpad_geometry_y_to_x(tp, speed_y * tp->scroll.vdist));
+		double factor = touchpad_accel_curve_gain(&tp->scroll.accel_curve, speed)/256.0;
+
+		speed_x *= factor;
+		speed_y *= factor;
+	}
+
+	if (hypot(speed_x, speed_y) < KINETIC_START_SPEED)
+		return false;
+
+	tp->scroll.state = SCROLL_STATE_KINETIC;
+	tp->scroll.kinetic.speed_x = speed_x;
+	tp->scroll.kinetic.speed_y = speed_y;
+	tp->scroll.kinetic.last = tp->ms;
+	tp->scroll.kinetic.timeout = tp->ms + KINETIC_INTERVAL;
+	touchpad_request_timer(tp, userdata, tp->ms, KINETIC_INTERVAL);
+
+	return true;
+}
+
+/**
+ * Kinetic scrolling: scroll by the distance covered at the current speed
+ * since the last tick, then slow down. The friction is applied per 10ms
+ * of elapsed time, so a late timer doesn't change the total distance.
+ *
+ * @return the time of the next tick, or 0 if kinetic scrolling is
+ * not active
+ */
+unsigned int
+touchpad_scroll_handle_timeout(struct touchpad *tp, unsigned int now, void *userdata)
+{
+	struct scroll *scroll = &tp->scroll;
+	unsigned int elapsed;
+	double units_x, units_y, friction;
+
+	if (scroll->state != SCROLL_STATE_KINETIC)
+		return 0;
+
+	if (scroll->kinetic.timeout > now)
+		return scroll->kinetic.timeout;
+
+	elapsed = now - scroll->kinetic.last;
+	units_x = scroll->kinetic.speed_x * elapsed/1000.0;
+	units_y = scroll->kinetic.speed_y * elapsed/1000.0;
+	friction = pow(1 - scroll->config.kinetic_friction/100.0, elapsed/10.0);
+	scroll->kinetic.speed_x *= friction;
+	scroll->kinetic.speed_y *= friction;
+	scroll->kinetic.last = now;
+
+	if (hypot(scroll->kinetic.speed_x, scroll->kinetic.speed_y) < KINETIC_STOP_SPEED) {
+		touchpad_scroll_stop(tp, userdata);
+		return 0;
+	}
+
+	if (units_y != 0.0)
+		touchpad_scroll_post(tp, userdata, TOUCHPAD_SCROLL_VERTICAL, units_y);
+	if (units_x != 0.0)
+		touchpad_scroll_post(tp, userdata, TOUCHPAD_SCROLL_HORIZONTAL, units_x);
+
+	scroll->kinetic.timeout = now + KINETIC_INTERVAL;
+	touchpad_request_timer(tp, userdata, now, KINETIC_INTERVAL);
+
+	return scroll->kinetic.timeout;
+}
+
+/**
+ * Kinetic scrolling stops when a new finger comes down or a button is
+ * pressed
+ */
+static bool
+touchpad_scroll_kinetic_interrupted(struct touchpad *tp)
+{
+	return tp->buttons.state != 0 || tp->frame.began > 0;
 }
 
 static int
@@ -63,9 +315,15 @@ touchpad_scroll_handle_2fg(struct touchpad *tp, void *userdata,
 	double dist = 0;
 
 	if (tp->fingers_down != 2) {
+		/* Only if both fingers lifted, a finger that stays
+		   down moves the pointer */
+		if (tp->scroll.state == SCROLL_STATE_SCROLLING &&
+		    tp->fingers_down == 0 &&
+		    touchpad_scroll_start_kinetic(tp, userdata))
+			return 1;
+
 		if (tp->scroll.state != SCROLL_STATE_NONE) {
-			tp->scroll.state = SCROLL_STATE_NONE;
-			tp->interface->scroll(tp, userdata, direction, 0);
+			touchpad_scroll_stop(tp, userdata);
 			return 1;
 		}
 		return 0;
@@ -74,7 +332,8 @@ touchpad_scroll_handle_2fg(struct touchpad *tp, void *userdata,
 	touchpad_for_each_touch(tp, t) {
 		double d;
 
-		if (!t->dirty || t->state != TOUCH_UPDATE)
+		if (!t->dirty || t->state != TOUCH_UPDATE ||
+		    t->thumb_state != THUMB_STATE_NO)
 			continue;
 
 		d = touchpad_scroll_units(tp, t, direction);
@@ -88,36 +347,217 @@ touchpad_scroll_handle_2fg(struct touchpad *tp, void *userdata,
 	if (abs(delta) < 1.0 && tp->scroll.state == SCROLL_STATE_NONE) {
 		delta = 0;
 	} else if (delta) {
-		tp->interface->scroll(tp, userdata, direction, delta);
+		touchpad_scroll_post(tp, userdata, direction, delta);
 		tp->scroll.state = SCROLL_STATE_SCROLLING;
 		tp->scroll.direction = direction;
+		tp->scroll.method = (direction == TOUCHPAD_SCROLL_VERTICAL) ?
+				    TOUCHPAD_SCROLL_TWOFINGER_VERTICAL :
+				    TOUCHPAD_SCROLL_TWOFINGER_HORIZONTAL;
 	}
 
 	return tp->scroll.state == SCROLL_STATE_SCROLLING;
 }
 
+/**
+ * Two-finger scrolling on both axes at once. Each touch's delta is
+ * converted once per frame and both axes are scrolled from the same
+ * touch, so a diagonal movement scrolls diagonally. With an axis lock,
+ * movement close to one axis only scrolls along that axis.
+ */
+static int
+touchpad_scroll_handle_2fg_2d(struct touchpad *tp, void *userdata)
+{
+	struct touch *t;
+	double ux = 0, uy = 0;
+	double dist = 0;
+
+	if (tp->fingers_down != 2) {
+		/* Only if both fingers lifted, a finger that stays
+		   down moves the pointer */
+		if (tp->scroll.state == SCROLL_STATE_SCROLLING &&
+		    tp->fingers_down == 0 &&
+		    touchpad_scroll_start_kinetic(tp, userdata))
+			return 1;
+
+		if (tp->scroll.state != SCROLL_STATE_NONE) {
+			touchpad_scroll_stop(tp, userdata);
+			return 1;
+		}
+		return 0;
+	}
+
+	touchpad_for_each_touch(tp, t) {
+		double x, y, factor;
+		int dx, dy;
+
+		if (!t->dirty || t->state != TOUCH_UPDATE ||
+		    t->thumb_state != THUMB_STATE_NO)
+			continue;
+
+		touchpad_motion_to_delta(t, &dx, &dy);
+		factor = touchpad_scroll_accel_factor(tp, t, dx, dy);
+		x = (double)dx/tp->scroll.hdist * factor;
+		y = (double)dy/tp->scroll.vdist * factor;
+		if (x * x + y * y > dist) {
+			dist = x * x + y * y;
+			ux = x;
+			uy = y;
+		}
+	}
+
+	/* require scroll dist for first scroll event */
+	if (dist < 1.0 && tp->scroll.state == SCROLL_STATE_NONE)
+		return 0;
+
+	if (fabs(uy) > fabs(ux)) {
+		if (fabs(ux) <= fabs(uy) * tp->scroll.axis_lock_slope)
+			ux = 0;
+	} else if (fabs(uy) <= fabs(ux) * tp->scroll.axis_lock_slope) {
+		uy = 0;
+	}
+
+	if (uy != 0.0)
+		touchpad_scroll_post(tp, userdata, TOUCHPAD_SCROLL_VERTICAL, uy);
+	if (ux != 0.0)
+		touchpad_scroll_post(tp, userdata, TOUCHPAD_SCROLL_HORIZONTAL, ux);
+
+	if (tp->scroll.state == SCROLL_STATE_NONE) {
+		tp->scroll.state = SCROLL_STATE_SCROLLING;
+		tp->scroll.method = SCROLL_TWOFINGER_BOTH;
+	}
+	if (ux != 0.0 || uy != 0.0)
+		tp->scroll.direction = (fabs(uy) >= fabs(ux)) ?
+					TOUCHPAD_SCROLL_VERTICAL :
+					TOUCHPAD_SCROLL_HORIZONTAL;
+
+	return 1;
+}
+
+/**
+ * The software buttons take precedence over the edge zones, a touch in
+ * the button area is about to click. On clickpads the bottom edge
+ * usually lies entirely within the button area.
+ */
+static enum scroll_edge
+touchpad_scroll_edge(struct touchpad *tp, struct touch *t)
+{
+	if (tp->buttons.in_button_area && tp->buttons.in_button_area(tp, t))
+		return SCROLL_EDGE_NONE;
+
+	if (t->x > tp->scroll.edge_right)
+		return SCROLL_EDGE_RIGHT;
+	else if (t->y > tp->scroll.edge_bottom)
+		return SCROLL_EDGE_BOTTOM;
+	return SCROLL_EDGE_NONE;
+}
+
+/**
+ * Track the edge zone each touch began in. A touch that leaves its zone
+ * before it started scrolling is a normal touch from then on, once it
+ * scrolls it keeps its zone until it ends.
+ */
+void
+touchpad_scroll_detect_edges(struct touchpad *tp)
+{
+	struct touch *t;
+
+	touchpad_for_each_touch(tp, t) {
+		switch (t->state) {
+			case TOUCH_BEGIN:
+				t->scroll_edge = touchpad_scroll_edge(tp, t);
+				break;
+			case TOUCH_UPDATE:
+				if (t->scroll_edge != SCROLL_EDGE_NONE &&
+				    tp->scroll.state == SCROLL_STATE_NONE &&
+				    touchpad_scroll_edge(tp, t) != t->scroll_edge)
+					t->scroll_edge = SCROLL_EDGE_NONE;
+				break;
+			default:
+				break;
+		}
+	}
+}
+
 static int
 touchpad_scroll_handle_edge(struct touchpad *tp, void *userdata,
 			    enum touchpad_scroll_direction direction)
 {
-	return 0; /* FIXME some more calculation needed */
+	enum scroll_edge edge = (direction == TOUCHPAD_SCROLL_VERTICAL) ?
+				SCROLL_EDGE_RIGHT : SCROLL_EDGE_BOTTOM;
+	struct touch *t, *touch = NULL;
+	double delta;
+
+	if (tp->fingers_down == 1) {
+		touchpad_for_each_touch(tp, t) {
+			if ((t->state == TOUCH_BEGIN || t->state == TOUCH_UPDATE) &&
+			    t->thumb_state == THUMB_STATE_NO) {
+				touch = t;
+				break;
+			}
+		}
+	}
+
+	if (!touch || touch->scroll_edge != edge) {
+		if (tp->scroll.state != SCROLL_STATE_NONE) {
+			tp->scroll.state = SCROLL_STATE_NONE;
+			touchpad_scroll_post(tp, userdata, direction, 0);
+			return 1;
+		}
+		return 0;
+	}
+
+	/* require scroll dist from where the touch began for the first
+	 * scroll event. Until then, the touch doesn't move the pointer
+	 * either. */
+	if (tp->scroll.state == SCROLL_STATE_NONE) {
+		struct touch_origin *origin = touchpad_touch_origin(tp, touch);
+
+		if (direction == TOUCHPAD_SCROLL_VERTICAL)
+			delta = (double)(touch->y - origin->y)/tp->scroll.vdist;
+		else
+			delta = (double)(touch->x - origin->x)/tp->scroll.hdist;
+
+		if (fabs(delta) < 1.0)
+			return 1;
+
+		tp->scroll.state = SCROLL_STATE_SCROLLING;
+		tp->scroll.direction = direction;
+		tp->scroll.method = (direction == TOUCHPAD_SCROLL_VERTICAL) ?
+				    TOUCHPAD_SCROLL_EDGE_VERTICAL :
+				    TOUCHPAD_SCROLL_EDGE_HORIZONTAL;
+		touchpad_scroll_post(tp, userdata, direction, delta);
+		return 1;
+	}
+
+	if (touch->dirty && touch->state == TOUCH_UPDATE) {
+		delta = touchpad_scroll_units(tp, touch, direction);
+		if (delta)
+			touchpad_scroll_post(tp, userdata, direction, delta);
+	}
+
+	return 1;
 }
 
 static int
 touchpad_scroll_continue(struct touchpad *tp, void *userdata)
 {
-	switch (tp->scroll.direction) {
-		case TOUCHPAD_SCROLL_VERTICAL:
-			if (tp->scroll.config.methods & TOUCHPAD_SCROLL_TWOFINGER_VERTICAL)
-				touchpad_scroll_handle_2fg(tp, userdata, tp->scroll.direction);
-			else if (tp->scroll.config.methods & TOUCHPAD_SCROLL_EDGE_VERTICAL)
-				touchpad_scroll_handle_edge(tp, userdata, TOUCHPAD_SCROLL_VERTICAL);
+	if (tp->scroll.method == SCROLL_TWOFINGER_BOTH) {
+		touchpad_scroll_handle_2fg_2d(tp, userdata);
+		return 1;
+	}
+
+	switch (tp->scroll.method) {
+		case TOUCHPAD_SCROLL_TWOFINGER_VERTICAL:
+		case TOUCHPAD_SCROLL_TWOFINGER_HORIZONTAL:
+			touchpad_scroll_handle_2fg(tp, userdata, tp->scroll.direction);
 			break;
-		case TOUCHPAD_SCROLL_HORIZONTAL:
-			if (tp->scroll.config.methods & TOUCHPAD_SCROLL_TWOFINGER_HORIZONTAL)
-				touchpad_scroll_handle_2fg(tp, userdata, tp->scroll.direction);
-			else if (tp->scroll.config.methods & TOUCHPAD_SCROLL_EDGE_HORIZONTAL)
-				touchpad_scroll_handle_edge(tp, userdata, TOUCHPAD_SCROLL_HORIZONTAL);
+		case TOUCHPAD_SCROLL_EDGE_VERTICAL:
+		case TOUCHPAD_SCROLL_EDGE_HORIZONTAL:
+			touchpad_scroll_handle_edge(tp, userdata, tp->scroll.direction);
+			break;
+		default:
+			log_bug(tp, true, "invalid scroll method %d\n", tp->scroll.method);
+			tp->scroll.state = SCROLL_STATE_NONE;
 			break;
 	}
 
@@ -129,6 +569,12 @@ touchpad_scroll_handle_state(struct touchpad *tp, void *userdata)
 {
 	int rc = 0;
 
+	if (tp->scroll.state == SCROLL_STATE_KINETIC) {
+		if (!touchpad_scroll_kinetic_interrupted(tp))
+			return 1;
+		touchpad_scroll_stop(tp, userdata);
+	}
+
 	/* Can't two-finger scroll with a clickpad button down */
 	if (tp->buttons.state != 0)
 		return 0;
@@ -136,17 +582,22 @@ touchpad_scroll_handle_state(struct touchpad *tp, void *userdata)
 	if (tp->scroll.state != SCROLL_STATE_NONE)
 		return touchpad_scroll_continue(tp, userdata);
 
-	if (tp->scroll.config.methods & TOUCHPAD_SCROLL_TWOFINGER_VERTICAL)
+	/* two-finger and edge scrolling need two fingers and one finger,
+	 * respectively, so at most one of them can trigger */
+	if (touchpad_scroll_two_axis(tp))
+		rc = touchpad_scroll_handle_2fg_2d(tp, userdata);
+	else if (tp->scroll.config.methods & TOUCHPAD_SCROLL_TWOFINGER_VERTICAL)
 		rc = touchpad_scroll_handle_2fg(tp, userdata, TOUCHPAD_SCROLL_VERTICAL);
-	else if (tp->scroll.config.methods & TOUCHPAD_SCROLL_EDGE_VERTICAL)
+	if (!rc && (tp->scroll.config.methods & TOUCHPAD_SCROLL_EDGE_VERTICAL))
 		rc = touchpad_scroll_handle_edge(tp, userdata, TOUCHPAD_SCROLL_VERTICAL);
 
 	if (rc)
 		return rc;
 
-	if (tp->scroll.config.methods & TOUCHPAD_SCROLL_TWOFINGER_HORIZONTAL)
+	if ((tp->scroll.config.methods & TOUCHPAD_SCROLL_TWOFINGER_HORIZONTAL) &&
+	    !touchpad_scroll_two_axis(tp))
 		rc = touchpad_scroll_handle_2fg(tp, userdata, TOUCHPAD_SCROLL_HORIZONTAL);
-	else if (tp->scroll.config.methods & TOUCHPAD_SCROLL_EDGE_HORIZONTAL)
+	if (!rc && (tp->scroll.config.methods & TOUCHPAD_SCROLL_EDGE_HORIZONTAL))
 		rc = touchpad_scroll_handle_edge(tp, userdata, TOUCHPAD_SCROLL_HORIZONTAL);
 
 	return rc;
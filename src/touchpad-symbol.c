@@ -0,0 +1,439 @@
+/*
+ * Copyright © 2013 Red Hat, Inc.
+ *
+ * Permission to use, copy, modify, distribute, and sell this software
+ * and its documentation for any purpose is hereby granted without
+ * fee, provided that the above copyright notice appear in all copies
+ * and that both that copyright notice and this permission notice
+ * appear in supporting documentation, and that the name of Red Hat
+ * not be used in advertising or publicity pertaining to distribution
+ * of the software without specific, written prior permission.  Red
+ * Hat makes no representations about the suitability of this software
+ * for any purpose.  It is provided "as is" without express or implied
+ * warranty.
+ *
+ * THE AUTHORS DISCLAIM ALL WARRANTIES WITH REGARD TO THIS SOFTWARE,
+ * INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS, IN
+ * NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY SPECIAL, INDIRECT OR
+ * CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS
+ * OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT,
+ * NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+ * CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <errno.h>
+#include <math.h>
+#include <string.h>
+#include "touchpad-int.h"
+
+/* the path is recorded with at least this distance between points */
+#define SYMBOL_SPACING 1 /* mm */
+
+/* template file format, all values little-endian */
+#define SYMBOL_FILE_MAGIC "TPSY"
+#define SYMBOL_FILE_VERSION 1
+#define SYMBOL_FILE_HEADER_SIZE 8 /* magic, version, reserved, count */
+#define SYMBOL_FILE_TEMPLATE_SIZE 3 /* id, npoints */
+
+/**
+ * Resample the path to SYMBOL_POINTS points evenly spaced along it,
+ * center it and scale it so its larger side spans -SYMBOL_SCALE to
+ * SYMBOL_SCALE. The aspect ratio is kept, so a horizontal line and a
+ * vertical line are different shapes.
+ *
+ * @return false if the path is smaller than min_size in both
+ * directions
+ */
+bool
+touchpad_symbol_shape(const int *x, const int *y, int npoints,
+		      int min_size, struct symbol_shape *shape)
+{
+	double rx[SYMBOL_POINTS], ry[SYMBOL_POINTS];
+	double length = 0, interval, d = 0;
+	double px, py, minx, maxx, miny, maxy, size, scale;
+	int count = 1;
+
+	if (npoints < 2)
+		return false;
+
+	minx = maxx = x[0];
+	miny = maxy = y[0];
+	for (int i = 1; i < npoints; i++) {
+		length += hypot(x[i] - x[i - 1], y[i] - y[i - 1]);
+		minx = min(minx, x[i]);
+		maxx = max(maxx, x[i]);
+		miny = min(miny, y[i]);
+		maxy = max(maxy, y[i]);
+	}
+
+	size = max(maxx - minx, maxy - miny);
+	if (size < max(min_size, 1))
+		return false;
+
+	interval = length/(SYMBOL_POINTS - 1);
+	px = rx[0] = x[0];
+	py = ry[0] = y[0];
+	for (int i = 1; i < npoints && count < SYMBOL_POINTS; i++) {
+		double segment = hypot(x[i] - px, y[i] - py);
+
+		while (d + segment >= interval && count < SYMBOL_POINTS) {
+			double t = (interval - d)/segment;
+
+			px += t * (x[i] - px);
+			py += t * (y[i] - py);
+			rx[count] = px;
+			ry[count] = py;
+			count++;
+			segment = hypot(x[i] - px, y[i] - py);
+			d = 0;
+		}
+
+		d += segment;
+		px = x[i];
+		py = y[i];
+	}
+
+	/* rounding may leave the last point short of the end */
+	for (; count < SYMBOL_POINTS; count++) {
+		rx[count] = x[npoints - 1];
+		ry[count] = y[npoints - 1];
+	}
+
+	scale = 2.0 * SYMBOL_SCALE/size;
+	for (int i = 0; i < SYMBOL_POINTS; i++) {
+		shape->x[i] = lround((rx[i] - (minx + maxx)/2) * scale);
+		shape->y[i] = lround((ry[i] - (miny + maxy)/2) * scale);
+	}
+
+	return true;
+}
+
+/**
+ * @return the sum of the squared distances between the points of a and
+ * b. At most SYMBOL_POINTS * 2 * (2 * SYMBOL_SCALE)², that fits.
+ */
+static inline int32_t
+symbol_distance(const struct symbol_shape *a, const struct symbol_shape *b)
+{
+	int32_t sum = 0;
+
+	for (int i = 0; i < SYMBOL_POINTS; i++) {
+		/* 16-bit differences make this a multiply-add of 16-bit pairs */
+		int16_t dx = a->x[i] - b->x[i];
+		int16_t dy = a->y[i] - b->y[i];
+
+		sum += dx * dx + dy * dy;
+	}
+
+	return sum;
+}
+
+/**
+ * @return the index of the template closest to the shape, or -1 if
+ * none is within the threshold
+ */
+int
+touchpad_symbol_match(const struct touchpad *tp, const struct symbol_shape *shape)
+{
+	const struct symbol *s = &tp->symbol;
+	/* the threshold is the RMS distance per point */
+	int64_t d = (int64_t)tp->gesture.config.symbol_threshold * 2 * SYMBOL_SCALE/100;
+	int32_t best = SYMBOL_POINTS * d * d;
+	int index = -1;
+
+	for (int i = 0; i < s->ntemplates; i++) {
+		int32_t distance = symbol_distance(&s->templates[i].shape, shape);
+
+		if (distance <= best) {
+			best = distance;
+			index = i;
+		}
+	}
+
+	return index;
+}
+
+/**
+ * Append a point to the path. If the path is full, every other point
+ * is dropped and the spacing doubles, so a long stroke costs the same
+ * memory as a short one.
+ */
+static void
+symbol_append(struct symbol *s, int x, int y)
+{
+	if (s->npoints == SYMBOL_MAX_PATH) {
+		for (int i = 1; i < SYMBOL_MAX_PATH/2; i++) {
+			s->x[i] = s->x[i * 2];
+			s->y[i] = s->y[i * 2];
+		}
+		s->npoints = SYMBOL_MAX_PATH/2;
+		s->spacing *= 2;
+	}
+
+	s->x[s->npoints] = x;
+	s->y[s->npoints] = y;
+	s->npoints++;
+}
+
+static void
+symbol_finish(struct touchpad *tp, void *userdata)
+{
+	struct symbol *s = &tp->symbol;
+	struct symbol_shape shape;
+	int min_size = touchpad_geometry_x_units(tp, SYMBOL_MIN_SIZE * 1000);
+	int index;
+
+	if (s->x[s->npoints - 1] != s->last_x || s->y[s->npoints - 1] != s->last_y)
+		symbol_append(s, s->last_x, s->last_y);
+
+	if (!touchpad_symbol_shape(s->x, s->y, s->npoints, min_size, &shape))
+		return;
+
+	index = touchpad_symbol_match(tp, &shape);
+	if (index < 0)
+		return;
+
+	log_debug(tp, "symbol %d\n", s->templates[index].id);
+	tp->interface.symbol(tp, userdata, s->templates[index].id);
+}
+
+void
+touchpad_symbol_cancel(struct touchpad *tp)
+{
+	if (tp->symbol.state == SYMBOL_STATE_RECORDING)
+		tp->symbol.state = SYMBOL_STATE_DONE;
+}
+
+/**
+ * Record the path of a single finger, and match it against the
+ * templates when the finger is lifted. The path is thinned out as it is
+ * recorded, so lifting the finger only resamples at most
+ * SYMBOL_MAX_PATH points and compares them to the templates.
+ *
+ * This never consumes the frame, the finger moves the pointer as usual.
+ * A second finger, a button press or anything else starting on the
+ * finger, e.g. a hold or an edge scroll, cancels the symbol.
+ */
+void
+touchpad_symbol_handle_state(struct touchpad *tp, void *userdata)
+{
+	struct symbol *s = &tp->symbol;
+	struct touch *touch;
+	int x, y, dx, dy;
+
+	if (tp->frame.fingers != 1) {
+		if (s->state == SYMBOL_STATE_RECORDING && tp->frame.fingers == 0)
+			symbol_finish(tp, userdata);
+		s->state = SYMBOL_STATE_NONE;
+		return;
+	}
+
+	/* the previous finger may have been lifted while a scroll owned the
+	 * frames, a new finger starts over */
+	if (tp->frame.began)
+		s->state = SYMBOL_STATE_NONE;
+
+	if (tp->buttons.state != 0) {
+		s->state = SYMBOL_STATE_DONE;
+		return;
+	}
+
+	if (s->state == SYMBOL_STATE_DONE)
+		return;
+
+	touch = touchpad_gesture_single_touch(tp);
+	if (touch == NULL)
+		return;
+
+	x = touch->x;
+	y = touchpad_geometry_y_to_x(tp, touch->y);
+
+	if (s->state == SYMBOL_STATE_NONE) {
+		s->state = SYMBOL_STATE_RECORDING;
+		s->spacing = max(1, touchpad_geometry_x_units(tp, SYMBOL_SPACING * 1000));
+		s->npoints = 0;
+		symbol_append(s, x, y);
+	}
+
+	s->last_x = x;
+	s->last_y = y;
+
+	dx = x - s->x[s->npoints - 1];
+	dy = y - s->y[s->npoints - 1];
+	if ((int64_t)dx * dx + (int64_t)dy * dy >= (int64_t)s->spacing * s->spacing)
+		symbol_append(s, x, y);
+}
+
+static int
+symbol_add_templates(struct touchpad *tp, const struct symbol_template *templates, int count)
+{
+	struct symbol *s = &tp->symbol;
+	struct symbol_template *new;
+
+	if (count == 0)
+		return 0;
+
+	new = realloc(s->templates, (s->ntemplates + count) * sizeof(*new));
+	if (!new)
+		return -ENOMEM;
+
+	memcpy(&new[s->ntemplates], templates, count * sizeof(*new));
+	s->templates = new;
+	s->ntemplates += count;
+
+	return 0;
+}
+
+int
+touchpad_symbol_add_template(struct touchpad *tp, int id,
+			     const int *x, const int *y, unsigned int npoints)
+{
+	struct symbol_template template;
+
+	if (!argcheck_ptr_not_null(tp) ||
+	    !argcheck_ptr_not_null(x) ||
+	    !argcheck_ptr_not_null(y))
+		return -EINVAL;
+
+	if (npoints > INT_MAX ||
+	    !touchpad_symbol_shape(x, y, npoints, 1, &template.shape))
+		return -EINVAL;
+
+	template.id = id;
+
+	return symbol_add_templates(tp, &template, 1);
+}
+
+static inline unsigned int
+le16(const uint8_t *data)
+{
+	return data[0] | data[1] << 8;
+}
+
+/**
+ * Parse a template file into templates, which has room for the count
+ * in the file's header. The file is checked completely before anything
+ * is added, a file with a broken template adds none.
+ *
+ * @return the number of templates, -EINVAL if the file is malformed or
+ * -ENOMEM
+ */
+static int
+symbol_parse_templates(const uint8_t *data, size_t size,
+		       struct symbol_template **templates)
+{
+	int x[UINT8_MAX], y[UINT8_MAX];
+	size_t offset = SYMBOL_FILE_HEADER_SIZE;
+	unsigned int count;
+
+	if (size < SYMBOL_FILE_HEADER_SIZE ||
+	    memcmp(data, SYMBOL_FILE_MAGIC, 4) != 0 ||
+	    data[4] != SYMBOL_FILE_VERSION)
+		return -EINVAL;
+
+	count = le16(&data[6]);
+	*templates = calloc(max(count, 1U), sizeof(**templates));
+	if (!*templates)
+		return -ENOMEM;
+
+	for (unsigned int i = 0; i < count; i++) {
+		unsigned int npoints;
+
+		if (size - offset < SYMBOL_FILE_TEMPLATE_SIZE)
+			goto error;
+
+		(*templates)[i].id = le16(&data[offset]);
+		npoints = data[offset + 2];
+		offset += SYMBOL_FILE_TEMPLATE_SIZE;
+
+		if (size - offset < npoints * 2)
+			goto error;
+
+		for (unsigned int p = 0; p < npoints; p++) {
+			x[p] = (int8_t)data[offset++];
+			y[p] = (int8_t)data[offset++];
+		}
+
+		if (!touchpad_symbol_shape(x, y, npoints, 1, &(*templates)[i].shape))
+			goto error;
+	}
+
+	if (offset != size)
+		goto error;
+
+	return count;
+
+error:
+	free(*templates);
+	*templates = NULL;
+	return -EINVAL;
+}
+
+int
+touchpad_symbol_load_templates(struct touchpad *tp, const char *path)
+{
+	struct symbol_template *templates = NULL;
+	uint8_t *data = NULL;
+	long size;
+	FILE *fp;
+	int rc;
+
+	if (!argcheck_ptr_not_null(tp) ||
+	    !argcheck_ptr_not_null(path))
+		return -EINVAL;
+
+	fp = fopen(path, "rb");
+	if (!fp)
+		return -errno;
+
+	if (fseek(fp, 0, SEEK_END) != 0 || (size = ftell(fp)) < 0) {
+		rc = -errno;
+		goto out;
+	}
+	rewind(fp);
+
+	data = malloc(max(size, 1L));
+	if (!data) {
+		rc = -ENOMEM;
+		goto out;
+	}
+
+	if (fread(data, 1, size, fp) != (size_t)size) {
+		rc = -EIO;
+		goto out;
+	}
+
+	rc = symbol_parse_templates(data, size, &templates);
+	if (rc >= 0)
+		rc = symbol_add_templates(tp, templates, rc);
+
+	if (rc == 0)
+		log_debug(tp, "%d symbol templates\n", tp->symbol.ntemplates);
+out:
+	free(templates);
+	free(data);
+	fclose(fp);
+	return rc;
+}
+
+void
+touchpad_symbol_clear_templates(struct touchpad *tp)
+{
+	if (!argcheck_ptr_not_null(tp))
+		return;
+
+	touchpad_symbol_free(tp);
+}
+
+void
+touchpad_symbol_free(struct touchpad *tp)
+{
+	free(tp->symbol.templates);
+	tp->symbol.templates = NULL;
+	tp->symbol.ntemplates = 0;
+	tp->symbol.state = SYMBOL_STATE_NONE;
+}
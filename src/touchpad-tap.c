@@ -125,7 +125,7 @@ touchpad_tap_touch_handle_event(struct touchpad *tp, enum tap_event event, void
 			break;
 		case TAP_EVENT_RELEASE:
 			tp->tap.state = TAP_STATE_TAPPED;
-			tp->interface->tap(tp, userdata, 1, true);
+			tp->interface.tap(tp, userdata, 1, true);
 			touchpad_tap_set_timer(tp, userdata);
 			break;
 		case TAP_EVENT_TIMEOUT:
@@ -177,11 +177,11 @@ touchpad_tap_tapped_handle_event(struct touchpad *tp, enum tap_event event, void
 			break;
 		case TAP_EVENT_TIMEOUT:
 			tp->tap.state = TAP_STATE_IDLE;
-			tp->interface->tap(tp, userdata, 1, false);
+			tp->interface.tap(tp, userdata, 1, false);
 			break;
 		case TAP_EVENT_BUTTON:
 			tp->tap.state = TAP_STATE_DEAD;
-			tp->interface->tap(tp, userdata, 1, false);
+			tp->interface.tap(tp, userdata, 1, false);
 			break;
 	}
 }
@@ -198,8 +198,8 @@ touchpad_tap_touch2_handle_event(struct touchpad *tp, enum tap_event event, void
 			break;
 		case TAP_EVENT_RELEASE:
 			tp->tap.state = TAP_STATE_HOLD;
-			tp->interface->tap(tp, userdata, 2, true);
-			tp->interface->tap(tp, userdata, 2, false);
+			tp->interface.tap(tp, userdata, 2, true);
+			tp->interface.tap(tp, userdata, 2, false);
 			touchpad_tap_clear_timer(tp, userdata);
 			break;
 		case TAP_EVENT_MOTION:
@@ -253,8 +253,8 @@ touchpad_tap_touch3_handle_event(struct touchpad *tp, enum tap_event event, void
 			break;
 		case TAP_EVENT_RELEASE:
 			tp->tap.state = TAP_STATE_TOUCH_2_HOLD;
-			tp->interface->tap(tp, userdata, 3, true);
-			tp->interface->tap(tp, userdata, 3, false);
+			tp->interface.tap(tp, userdata, 3, true);
+			tp->interface.tap(tp, userdata, 3, false);
 			break;
 		case TAP_EVENT_BUTTON:
 			tp->tap.state = TAP_STATE_DEAD;
@@ -293,9 +293,9 @@ touchpad_tap_dragging_or_doubletap_handle_event(struct touchpad *tp, enum tap_ev
 			break;
 		case TAP_EVENT_RELEASE:
 			tp->tap.state = TAP_STATE_IDLE;
-			tp->interface->tap(tp, userdata, 1, false);
-			tp->interface->tap(tp, userdata, 1, true);
-			tp->interface->tap(tp, userdata, 1, false);
+			tp->interface.tap(tp, userdata, 1, false);
+			tp->interface.tap(tp, userdata, 1, true);
+			tp->interface.tap(tp, userdata, 1, false);
 			touchpad_tap_clear_timer(tp, userdata);
 			break;
 		case TAP_EVENT_MOTION:
@@ -304,7 +304,7 @@ touchpad_tap_dragging_or_doubletap_handle_event(struct touchpad *tp, enum tap_ev
 			break;
 		case TAP_EVENT_BUTTON:
 			tp->tap.state = TAP_STATE_DEAD;
-			tp->interface->tap(tp, userdata, 1, false);
+			tp->interface.tap(tp, userdata, 1, false);
 			break;
 	}
 }
@@ -328,7 +328,7 @@ touchpad_tap_dragging_handle_event(struct touchpad *tp, enum tap_event event, vo
 			break;
 		case TAP_EVENT_BUTTON:
 			tp->tap.state = TAP_STATE_DEAD;
-			tp->interface->tap(tp, userdata, 1, false);
+			tp->interface.tap(tp, userdata, 1, false);
 			break;
 	}
 }
@@ -348,11 +348,11 @@ touchpad_tap_dragging_wait_handle_event(struct touchpad *tp, enum tap_event even
 			break;
 		case TAP_EVENT_TIMEOUT:
 			tp->tap.state = TAP_STATE_IDLE;
-			tp->interface->tap(tp, userdata, 1, false);
+			tp->interface.tap(tp, userdata, 1, false);
 			break;
 		case TAP_EVENT_BUTTON:
 			tp->tap.state = TAP_STATE_DEAD;
-			tp->interface->tap(tp, userdata, 1, false);
+			tp->interface.tap(tp, userdata, 1, false);
 			break;
 	}
 }
@@ -368,7 +368,7 @@ touchpad_tap_dragging2_handle_event(struct touchpad *tp, enum tap_event event, v
 			break;
 		case TAP_EVENT_TOUCH:
 			tp->tap.state = TAP_STATE_DEAD;
-			tp->interface->tap(tp, userdata, 1, false);
+			tp->interface.tap(tp, userdata, 1, false);
 			break;
 		case TAP_EVENT_MOTION:
 		case TAP_EVENT_TIMEOUT:
@@ -376,7 +376,7 @@ touchpad_tap_dragging2_handle_event(struct touchpad *tp, enum tap_event event, v
 			break;
 		case TAP_EVENT_BUTTON:
 			tp->tap.state = TAP_STATE_DEAD;
-			tp->interface->tap(tp, userdata, 1, false);
+			tp->interface.tap(tp, userdata, 1, false);
 			break;
 	}
 }
@@ -456,12 +456,13 @@ touchpad_tap_handle_event(struct touchpad *tp, enum tap_event event, void *userd
 static bool
 touchpad_tap_exceeds_motion_threshold(struct touchpad *tp, struct touch *t)
 {
-	int threshold = tp->tap.config.move_threshold;
+	int64_t threshold = tp->tap.move_threshold;
 	int dx, dy;
 
 	touchpad_motion_to_delta(t, &dx, &dy);
+	dy = touchpad_geometry_y_to_x(tp, dy);
 
-	return dx * dx + dy * dy > threshold * threshold;
+	return (int64_t)dx * dx + (int64_t)dy * dy > threshold * threshold;
 }
 
 int
@@ -473,6 +474,14 @@ touchpad_tap_handle_state(struct touchpad *tp, void *userdata)
 		touchpad_tap_handle_event(tp, TAP_EVENT_BUTTON, userdata);
 
 	touchpad_for_each_touch(tp, t) {
+		/* a finger that turns out to be a thumb lifts as far as
+		   tapping is concerned, and is ignored from then on */
+		if (t->thumb_state == THUMB_STATE_NEW &&
+		    tp->tap.state != TAP_STATE_IDLE)
+			touchpad_tap_handle_event(tp, TAP_EVENT_RELEASE, userdata);
+		if (t->thumb_state != THUMB_STATE_NO)
+			continue;
+
 		if (!t->dirty || t->state == TOUCH_NONE)
 			continue;
 
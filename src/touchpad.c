@@ -28,6 +28,7 @@
 #include <errno.h>
 #include <fcntl.h>
 #include <stdarg.h>
+#include <stddef.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -38,6 +39,7 @@
 #include <sys/timerfd.h>
 #include <sys/types.h>
 #include <libevdev/libevdev.h>
+#include <ccan/build_assert/build_assert.h>
 
 #include "touchpad-int.h"
 #include "touchpad-config.h"
@@ -100,6 +102,10 @@ touch_init(struct touchpad *tp, struct touch *t)
 	t->x = t->y = 0;
 	t->state = TOUCH_NONE;
 	t->button_state = BUTTON_STATE_NONE;
+	t->thumb_state = THUMB_STATE_NO;
+	t->scroll_edge = SCROLL_EDGE_NONE;
+	t->hovering = false;
+	t->resting = false;
 	touchpad_history_reset(tp, t);
 }
 
@@ -110,16 +116,89 @@ touchpad_reset(struct touchpad *tp)
 
 	for (i = 0; i < MAX_TOUCHPOINTS; i++)
 		touch_init(tp, &tp->touches[i]);
+	tp->fingers_down = 0;
+	tp->thumbs_down = 0;
 	tp->slot = libevdev_get_current_slot(tp->dev);
 	tp->tap.state = TAP_STATE_IDLE;
 	tp->scroll.state = SCROLL_STATE_NONE;
+	tp->scroll.kinetic.timeout = 0;
+	tp->scroll.hires_remainder_x = 0;
+	tp->scroll.hires_remainder_y = 0;
+	tp->gesture.state = GESTURE_STATE_NONE;
+	tp->gesture.swipe.fingers = 0;
+	tp->gesture.swipe.active = false;
+	tp->gesture.hold.state = HOLD_STATE_NONE;
+	tp->gesture.hold.timeout = 0;
+	tp->symbol.state = SYMBOL_STATE_NONE;
+	tp->frame.fingers = 0;
+	tp->frame.scrolling = false;
+	tp->semi_mt.nfingers = 0;
+}
+
+/* width assumed for devices that don't announce a resolution */
+#define NOMINAL_WIDTH 100 /* mm */
+
+/**
+ * Set the touchpad's geometry. If either resolution is missing, the
+ * touchpad is assumed to be NOMINAL_WIDTH mm wide, with square units.
+ *
+ * This doesn't convert the thresholds, call
+ * touchpad_config_apply_geometry() afterwards.
+ */
+void
+touchpad_geometry_set(struct touchpad *tp,
+		      int minx, int maxx, int xres,
+		      int miny, int maxy, int yres)
+{
+	struct touchpad_geometry *g = &tp->geometry;
+
+	g->estimated = xres <= 0 || yres <= 0;
+	if (g->estimated) {
+		xres = max(1, (maxx - minx)/NOMINAL_WIDTH);
+		yres = xres;
+	}
+
+	g->minx = minx;
+	g->maxx = maxx;
+	g->miny = miny;
+	g->maxy = maxy;
+	g->xres = xres;
+	g->yres = yres;
+	g->width = (maxx - minx)/xres;
+	g->height = (maxy - miny)/yres;
+	g->anisotropy = yres * 256/xres;
+}
+
+static void
+touchpad_geometry_init(struct touchpad *tp)
+{
+	int xaxis = ABS_MT_POSITION_X,
+	    yaxis = ABS_MT_POSITION_Y;
+
+	if (!libevdev_has_event_code(tp->dev, EV_ABS, xaxis) ||
+	    !libevdev_has_event_code(tp->dev, EV_ABS, yaxis)) {
+		xaxis = ABS_X;
+		yaxis = ABS_Y;
+	}
+
+	touchpad_geometry_set(tp,
+			      libevdev_get_abs_minimum(tp->dev, xaxis),
+			      libevdev_get_abs_maximum(tp->dev, xaxis),
+			      libevdev_get_abs_resolution(tp->dev, xaxis),
+			      libevdev_get_abs_minimum(tp->dev, yaxis),
+			      libevdev_get_abs_maximum(tp->dev, yaxis),
+			      libevdev_get_abs_resolution(tp->dev, yaxis));
 }
 
 struct touchpad*
 touchpad_alloc(void)
 {
-	struct touchpad *tp = zalloc(sizeof(struct touchpad));
+	struct touchpad *tp;
+
+	/* every touch is processed on every frame, keep them small */
+	BUILD_ASSERT(sizeof(struct touch) <= TOUCH_MAX_SIZE);
 
+	tp = zalloc(sizeof(struct touchpad));
 	if (tp) {
 		tp->ntouches = 0;
 		tp->dev = libevdev_new();
@@ -129,6 +208,10 @@ touchpad_alloc(void)
 		tp->buttons.handle_state = touchpad_button_handle_state;
 		tp->buttons.handle_timeout = touchpad_button_handle_timeout;
 		tp->buttons.select_pointer_touch = touchpad_button_select_pointer_touch;
+		tp->buttons.detect_thumbs = touchpad_button_detect_thumbs;
+		tp->buttons.in_button_area = touchpad_button_in_area;
+		/* until we have a device */
+		touchpad_geometry_set(tp, 0, 4000, 0, 0, 2400, 0);
 		touchpad_config_set_static_defaults(tp);
 		touchpad_reset(tp);
 	}
@@ -186,6 +269,48 @@ fail:
 
 }
 
+/**
+ * Find the pressure axis for the touch qualification. Without a
+ * per-touch pressure, ABS_PRESSURE is only usable if the device tracks a
+ * single contact anyway.
+ */
+static void
+touchpad_pressure_init(struct touchpad *tp)
+{
+	struct qualify *q = &tp->qualify;
+	unsigned int axis;
+
+	q->mt_pressure = libevdev_has_event_code(tp->dev, EV_ABS, ABS_MT_PRESSURE);
+	if (q->mt_pressure)
+		axis = ABS_MT_PRESSURE;
+	else if (tp->maxtouches == -1 || tp->semi_mt.enabled)
+		axis = ABS_PRESSURE;
+	else
+		return;
+
+	if (!libevdev_has_event_code(tp->dev, EV_ABS, axis))
+		return;
+
+	q->pressure_min = libevdev_get_abs_minimum(tp->dev, axis);
+	q->pressure_max = libevdev_get_abs_maximum(tp->dev, axis);
+}
+
+/**
+ * Find the touch size axis for the palm check.
+ */
+static void
+touchpad_touch_major_init(struct touchpad *tp)
+{
+	struct qualify *q = &tp->qualify;
+
+	if (!libevdev_has_event_code(tp->dev, EV_ABS, ABS_MT_TOUCH_MAJOR))
+		return;
+
+	q->major_min = libevdev_get_abs_minimum(tp->dev, ABS_MT_TOUCH_MAJOR);
+	q->major_max = libevdev_get_abs_maximum(tp->dev, ABS_MT_TOUCH_MAJOR);
+	q->major_res = libevdev_get_abs_resolution(tp->dev, ABS_MT_TOUCH_MAJOR);
+}
+
 int
 touchpad_new_from_fd(int fd, struct touchpad **tp_out)
 {
@@ -242,14 +367,22 @@ touchpad_new_from_fd(int fd, struct touchpad **tp_out)
 		tp->slot = 0;
 		tp->ntouches = max(tp->ntouches, 1);
 		tp->update_abs_state = touchpad_st_update_abs_state;
+	} else if (libevdev_has_property(tp->dev, INPUT_PROP_SEMI_MT)) {
+		tp->semi_mt.enabled = true;
+		tp->update_abs_state = touchpad_semi_mt_update_abs_state;
 	}
 
 	if (libevdev_has_event_code(tp->dev, EV_KEY, BTN_RIGHT)) {
 		tp->buttons.handle_state = touchpad_phys_button_handle_state;
 		tp->buttons.handle_timeout = touchpad_phys_button_handle_timeout;
 		tp->buttons.select_pointer_touch = touchpad_phys_button_select_pointer_touch;
+		tp->buttons.detect_thumbs = NULL;
+		tp->buttons.in_button_area = NULL;
 	}
 
+	touchpad_geometry_init(tp);
+	touchpad_pressure_init(tp);
+	touchpad_touch_major_init(tp);
 	touchpad_config_set_dynamic_defaults(tp);
 
 	*tp_out = tp;
@@ -267,6 +400,7 @@ touchpad_free(struct touchpad *tp)
 
 	libevdev_free(tp->dev);
 	close(tp->epollfd);
+	touchpad_symbol_free(tp);
 	free(tp);
 }
 
@@ -299,9 +433,36 @@ touchpad_get_fd(struct touchpad *tp)
 int
 touchpad_get_min_max(struct touchpad *tp, int axis, int *min, int *max, int *res)
 {
+	const struct touchpad_geometry *g;
+
 	if (!argcheck_ptr_not_null(tp))
 		return -1;
 
+	g = &tp->geometry;
+
+	/* x and y come from the geometry, whether the device has MT axes or
+	 * not. The resolution may be estimated. */
+	switch (axis) {
+		case ABS_X:
+		case ABS_MT_POSITION_X:
+			if (min)
+				*min = g->minx;
+			if (max)
+				*max = g->maxx;
+			if (res)
+				*res = g->xres;
+			return 0;
+		case ABS_Y:
+		case ABS_MT_POSITION_Y:
+			if (min)
+				*min = g->miny;
+			if (max)
+				*max = g->maxy;
+			if (res)
+				*res = g->yres;
+			return 0;
+	}
+
 	if (!libevdev_has_event_code(tp->dev, EV_ABS, axis))
 			return -1;
 
@@ -314,19 +475,44 @@ touchpad_get_min_max(struct touchpad *tp, int axis, int *min, int *max, int *res
 	return 0;
 }
 
+unsigned int
+touchpad_get_jump_count(struct touchpad *tp)
+{
+	if (!argcheck_ptr_not_null(tp))
+		return 0;
+
+	return tp->filter.jumps;
+}
+
 void
 touchpad_set_interface(struct touchpad *tp, const struct touchpad_interface *interface)
 {
-	if (!argcheck_ptr_not_null(interface))
+	/* callers of this function were built against the interface that
+	   ended with pinch */
+	touchpad_set_interface_v2(tp, interface,
+				  offsetof(struct touchpad_interface, swipe_begin));
+}
+
+void
+touchpad_set_interface_v2(struct touchpad *tp,
+			  const struct touchpad_interface *interface,
+			  size_t size)
+{
+	struct touchpad_interface *iface = &tp->interface;
+
+	if (!argcheck_ptr_not_null(interface) ||
+	    !argcheck_int_ge(size, offsetof(struct touchpad_interface, swipe_begin)))
 		return;
-	argcheck_ptr_not_null(interface->motion);
-	argcheck_ptr_not_null(interface->button);
-	argcheck_ptr_not_null(interface->scroll);
-	argcheck_ptr_not_null(interface->tap);
-	argcheck_ptr_not_null(interface->rotate);
-	argcheck_ptr_not_null(interface->pinch);
-
-	tp->interface = interface;
+
+	/* the callbacks the caller doesn't know about are NULL */
+	memset(iface, 0, sizeof(*iface));
+	memcpy(iface, interface, min(size, sizeof(*iface)));
+
+	argcheck_ptr_not_null(iface->motion);
+	argcheck_ptr_not_null(iface->button);
+	if (!iface->scroll_hires)
+		argcheck_ptr_not_null(iface->scroll);
+	argcheck_ptr_not_null(iface->tap);
 }
 
 
@@ -410,6 +596,14 @@ touchpad_handle_timeouts(struct touchpad *tp, void *userdata, unsigned int now)
 	if (timeout)
 		next_timeout = min(timeout, next_timeout);
 
+	timeout = touchpad_scroll_handle_timeout(tp, now, userdata);
+	if (timeout)
+		next_timeout = min(timeout, next_timeout);
+
+	timeout = touchpad_gesture_handle_timeout(tp, now, userdata);
+	if (timeout)
+		next_timeout = min(timeout, next_timeout);
+
 	tp->next_timeout = (next_timeout == INT_MAX) ? 0 : next_timeout;
 	if (tp->next_timeout)
 		argcheck_uint_ge(tp->next_timeout, now);
@@ -431,7 +625,7 @@ touchpad_handle_events(struct touchpad *tp, void *userdata)
 	enum libevdev_read_flag mode = LIBEVDEV_READ_FLAG_NORMAL;
 	struct epoll_event events[3];
 
-	argcheck_ptr_not_null(tp->interface);
+	argcheck_ptr_not_null(tp->interface.motion);
 
 
 	rc = epoll_wait(tp->epollfd, events, ARRAY_LENGTH(events), 0);
@@ -26,6 +26,7 @@
 
 #include <stdbool.h>
 #include <stdarg.h>
+#include <stddef.h>
 
 /**
  * @mainpage
@@ -91,7 +92,7 @@
  * @page scrolling Scrolling gesture recognition
  *
  * libtouchpad supports two scroll methods: two-finger scrolling and
- * (eventually) edge scrolling
+ * edge scrolling
  *
  * Two-finger Scrolling
  * ====================
@@ -103,12 +104,35 @@
  * Two-finger scrolling terminates when one finger leaves the touchpad or a
  * third finger is placed onto the touchpad.
  *
+ * If both two-finger methods are enabled, scrolling is usually locked to
+ * the direction it started in. With TOUCHPAD_CONFIG_SCROLL_TWO_AXIS, each
+ * movement scrolls on both axes instead, except for movements close to
+ * one axis, see TOUCHPAD_CONFIG_SCROLL_AXIS_LOCK.
+ *
+ * Kinetic Scrolling
+ * =================
+ * If enabled, lifting both fingers off together during a two-finger
+ * scroll doesn't terminate the scroll right away. Scrolling continues from a timer at the
+ * speed the fingers had when they lifted off and slows down until it
+ * stops. A new finger on the touchpad or a button press stops it
+ * immediately. See TOUCHPAD_CONFIG_SCROLL_KINETIC.
+ *
+ * Scroll Acceleration
+ * ===================
+ * If enabled, fast finger movements scroll further than slow ones, along
+ * a curve like the pointer acceleration's. Slow scrolling is scrolled
+ * as-is. This applies to the speed kinetic scrolling starts with, too.
+ * See TOUCHPAD_CONFIG_SCROLL_ACCEL_PROFILE.
+ *
  * Edge Scrolling
  * ====================
- * **Note: not implemented**
- *
  * In edge scrolling, a movement of exactly one fingers along a defined edge
- * by more than a given threshold will trigger a scroll event.
+ * by more than a given threshold will trigger a scroll event. The right
+ * edge scrolls vertically, the bottom edge horizontally. The finger must
+ * begin in the edge zone, a finger that leaves the zone before it
+ * scrolled moves the pointer instead. While in the zone, the finger
+ * doesn't move the pointer. On clickpads, the software button area is
+ * not part of either zone, a finger there clicks instead.
  *
  * Edge scrolling terminates when the finger leaves the touchpad or a second
  * finger is placed onto the touchpad.
@@ -118,7 +142,63 @@
  * Once a scroll gesture has started, the scroll direction and method is
  * locked and will not change until the scroll terminates. For example, if a
  * vertical two-finger scroll has been triggerd, sideways movement will not
- * trigger horizontal scrolling.
+ * trigger horizontal scrolling. Two-axis scrolling is the exception, it
+ * scrolls along both axes until it terminates.
+ */
+
+/**
+ * @page gestures Multi-finger gestures
+ *
+ * Pinch and Rotate
+ * ================
+ * With two fingers on the touchpad, moving them apart or together is a
+ * pinch, turning them around each other is a rotation. Both may happen
+ * at the same time.
+ *
+ * A pinch or rotation only starts once both fingers moved, in opposite
+ * directions, and the distance or the angle between them changed by a
+ * threshold. Until then, the fingers may still start a two-finger
+ * scroll instead. Once either the gesture or the scroll started, the
+ * other one is locked out until the number of fingers changes.
+ *
+ * Swipe Gestures
+ * ==============
+ * Three or more fingers moving together are a swipe. A swipe begins once
+ * the fingers' centroid moved by a threshold and ends when a finger is
+ * lifted or added. While three or more fingers are down, they don't
+ * move the pointer.
+ *
+ * Hold Gestures
+ * =============
+ * A single finger that rests on the touchpad, i.e. doesn't move further
+ * than the tap movement threshold, for TOUCHPAD_CONFIG_HOLD_TIMEOUT is a
+ * hold. The hold ends when the finger is lifted, moves, or another finger
+ * or a button is pressed. While it lasts, the finger doesn't move the
+ * pointer. Holds are off by default, see TOUCHPAD_GESTURE_HOLD.
+ *
+ * Symbol Gestures
+ * ===============
+ * A single finger tracing a shape, e.g. a circle, a check mark or a
+ * letter, is a symbol if the shape matches one of the templates
+ * registered with touchpad_symbol_add_template() or
+ * touchpad_symbol_load_templates(). The stroke and the templates are
+ * resampled to the same number of points along their path and scaled to
+ * the same size, the closest template within
+ * TOUCHPAD_CONFIG_SYMBOL_THRESHOLD is the symbol. The direction a
+ * template is traced in matters, a template per direction is needed to
+ * match both. The shape is matched when the finger is lifted; a second
+ * finger, a button press, a hold or a scroll cancels it.
+ *
+ * The finger moves the pointer while it traces the symbol. Symbols are
+ * off by default, see TOUCHPAD_GESTURE_SYMBOL.
+ *
+ * Arbitration
+ * ===========
+ * Each frame goes to at most one of the pointer, scrolling, pinch and
+ * rotate, swipes or holds. Whichever started first keeps the fingers until it
+ * ends. For example, a third finger during a two-finger scroll
+ * terminates the scroll, only then can the fingers start a swipe.
+ * Symbols don't take part, they watch the frames the pointer gets.
  */
 
 /**
@@ -185,6 +265,13 @@ enum touchpad_scroll_direction {
 	TOUCHPAD_SCROLL_VERTICAL,
 };
 
+/**
+ * The number of high-resolution units in one scroll unit, see
+ * struct touchpad_interface::scroll_hires. This matches the kernel's
+ * REL_WHEEL_HI_RES, where one wheel detent is 120.
+ */
+#define TOUCHPAD_SCROLL_HIRES_UNITS 120
+
 enum touchpad_scroll_methods {
 	TOUCHPAD_SCROLL_NONE = 0x0,
 	TOUCHPAD_SCROLL_EDGE_VERTICAL = 0x1,
@@ -197,7 +284,10 @@ enum touchpad_scroll_methods {
  * @ingroup callbackinterface
  *
  * Callback interface used by the backends to get notified about
- * events on the touchpad.
+ * events on the touchpad. New callbacks are only ever added at the end
+ * and touchpad_set_interface_v2() copies the struct by the size the
+ * caller was built with, so a caller built against an older version
+ * leaves the newer callbacks NULL.
  */
 struct touchpad_interface {
 	/**
@@ -243,7 +333,8 @@ struct touchpad_interface {
 	/**
 	 * Called for a scroll event. The first scroll event will always be
 	 * 1 unit or more, other scroll events may be less than one unit. A
-	 * unit count of 0 signals that scrolling has terminated.
+	 * unit count of 0 signals that scrolling has terminated. With
+	 * kinetic scrolling, that is after the kinetic scroll stopped.
 	 *
 	 * @param tp The touchpad device
 	 * @param userdata Backend-specific data, see
@@ -257,7 +348,8 @@ struct touchpad_interface {
 
 	/**
 	 * Called for a rotate event, i.e. two fingers down rotating around
-	 * each other.
+	 * each other. See @ref gestures. Optional, if NULL rotations
+	 * aren't recognized.
 	 *
 	 * @param tp The touchpad device
 	 * @param userdata Backend-specific data, see
@@ -268,7 +360,8 @@ struct touchpad_interface {
 
 	/**
 	 * Called for a pinch event, i.e. two fingers moving towards each
-	 * other.
+	 * other. See @ref gestures. Optional, if NULL pinches aren't
+	 * recognized.
 	 *
 	 * @param tp The touchpad device
 	 * @param userdata Backend-specific data, see
@@ -277,6 +370,93 @@ struct touchpad_interface {
 	 * previous position, i.e. 200 means the distance doubled.
 	 */
 	void (*pinch)(struct touchpad *tp, void *userdata, int scale);
+
+	/**
+	 * Called when three or more fingers start moving together. See
+	 * @ref gestures. Optional, swipes are only recognized if
+	 * swipe_begin, swipe_update and swipe_end are all set.
+	 *
+	 * @param tp The touchpad device
+	 * @param userdata Backend-specific data, see
+	 *	  touchpad_handle_events()
+	 * @param fingers The number of fingers swiping
+	 */
+	void (*swipe_begin)(struct touchpad *tp, void *userdata,
+			    unsigned int fingers);
+	/**
+	 * Called for each movement of a swipe, after swipe_begin.
+	 *
+	 * @param tp The touchpad device
+	 * @param userdata Backend-specific data, see
+	 *	  touchpad_handle_events()
+	 * @param fingers The number of fingers swiping
+	 * @param dx The x movement of the fingers' centroid in device units
+	 * @param dy The y movement of the fingers' centroid in device units
+	 */
+	void (*swipe_update)(struct touchpad *tp, void *userdata,
+			     unsigned int fingers, int dx, int dy);
+	/**
+	 * Called when a swipe ends, i.e. a finger was lifted or added.
+	 *
+	 * @param tp The touchpad device
+	 * @param userdata Backend-specific data, see
+	 *	  touchpad_handle_events()
+	 * @param fingers The number of fingers of the swipe that ended
+	 */
+	void (*swipe_end)(struct touchpad *tp, void *userdata,
+			  unsigned int fingers);
+
+	/**
+	 * Optional, if set it is called instead of struct
+	 * touchpad_interface::scroll and scroll may be NULL. The same
+	 * scroll events in integer units of 1/TOUCHPAD_SCROLL_HIRES_UNITS,
+	 * i.e. the first scroll event will always be
+	 * TOUCHPAD_SCROLL_HIRES_UNITS or more. The fractions of a
+	 * high-resolution unit are carried over to the next event, so the
+	 * sum of the values is exact. A value of 0 signals that scrolling
+	 * has terminated.
+	 *
+	 * @param tp The touchpad device
+	 * @param userdata Backend-specific data, see
+	 *	  touchpad_handle_events()
+	 * @param direction The scrolling direction
+	 * @param value The high-resolution units scrolled in that
+	 *		direction, or 0 if the scroll gesture terminated.
+	 */
+	void (*scroll_hires)(struct touchpad *tp, void *userdata,
+			     enum touchpad_scroll_direction direction, int value);
+
+	/**
+	 * Called when a single finger has rested on the touchpad for long
+	 * enough to be a hold. See @ref gestures. Optional, holds are only
+	 * recognized if hold_begin and hold_end are both set.
+	 *
+	 * @param tp The touchpad device
+	 * @param userdata Backend-specific data, see
+	 *	  touchpad_handle_events()
+	 */
+	void (*hold_begin)(struct touchpad *tp, void *userdata);
+	/**
+	 * Called when a hold ends.
+	 *
+	 * @param tp The touchpad device
+	 * @param userdata Backend-specific data, see
+	 *	  touchpad_handle_events()
+	 * @param cancelled False if the finger was lifted, true if it moved
+	 *	  or another finger or a button was pressed
+	 */
+	void (*hold_end)(struct touchpad *tp, void *userdata, bool cancelled);
+
+	/**
+	 * Called when a finger that traced a symbol is lifted. See @ref
+	 * gestures. Optional, if NULL symbols aren't recognized.
+	 *
+	 * @param tp The touchpad device
+	 * @param userdata Backend-specific data, see
+	 *	  touchpad_handle_events()
+	 * @param id The id of the matching template
+	 */
+	void (*symbol)(struct touchpad *tp, void *userdata, int id);
 };
 
 /**
@@ -316,22 +496,112 @@ int touchpad_change_fd(struct touchpad *tp, int fd);
  * @ingroup api
  *
  * Get axis information from the device.
+ *
+ * ABS_X and ABS_MT_POSITION_X (and ABS_Y and ABS_MT_POSITION_Y) both
+ * return the axis the touchpad uses for positions. If the device doesn't
+ * announce a resolution for these axes, an estimate is returned.
+ *
  * @param tp A previously opened touchpad device
  * @param axis An absolute axis code as defined in linux/input.h (ABS_X, ABS_Y..)
  * @param min If not NULL, min is set to the minimum value for this axis
  * @param max If not NULL, max is set to the maximum value for this axis
- * @param res If not NULL, res is set to the resolution of this axis
+ * @param res If not NULL, res is set to the resolution of this axis in
+ * units/mm
  * @return 0 on success or -1 if the axis is not available on this device
  */
 int touchpad_get_min_max(struct touchpad *tp, int axis, int *min, int *max, int *res);
+
 /**
  * @ingroup api
  *
- * Set the interface for event handling
+ * Get the number of positions discarded because the finger couldn't have
+ * moved there that fast, see TOUCHPAD_MOTION_FILTER_JUMP. A touchpad with
+ * a high count has firmware that sends bogus coordinates.
+ *
+ * @param tp A previously opened touchpad device
+ * @return the number of positions discarded since the device was opened
+ */
+unsigned int touchpad_get_jump_count(struct touchpad *tp);
+
+/**
+ * @ingroup api
+ *
+ * Add a template for symbol gestures, see @ref gestures. The template is
+ * a path of npoints points, in any units with y growing downwards like
+ * the touchpad's coordinates. Only its shape matters, not its size or
+ * position.
+ *
+ * @param tp A previously opened touchpad device
+ * @param id The id passed to struct touchpad_interface::symbol
+ * @param x The x coordinates of the path
+ * @param y The y coordinates of the path
+ * @param npoints The number of points, at least 2
+ * @return 0 on success or a negative errno on failure, -EINVAL if the
+ * path has no extent
+ */
+int touchpad_symbol_add_template(struct touchpad *tp, int id,
+				 const int *x, const int *y,
+				 unsigned int npoints);
+
+/**
+ * @ingroup api
+ *
+ * Add the templates in the given file, see
+ * touchpad_symbol_add_template(). All values are little-endian:
+ *
+ *      offset  size  content
+ *      0       4     "TPSY"
+ *      4       1     version, 1
+ *      5       1     reserved, 0
+ *      6       2     number of templates
+ *      8             the templates, each:
+ *              2       id, unsigned
+ *              1       number of points, at least 2
+ *              2 * n   the points as signed 8-bit x, y pairs
+ *
+ * If the file is malformed, none of its templates are added.
+ *
+ * @param tp A previously opened touchpad device
+ * @param path The path to the template file
+ * @return 0 on success or a negative errno on failure, -EINVAL if the
+ * file is malformed
+ */
+int touchpad_symbol_load_templates(struct touchpad *tp, const char *path);
+
+/**
+ * @ingroup api
+ *
+ * Remove all symbol templates.
+ *
+ * @param tp A previously opened touchpad device
+ */
+void touchpad_symbol_clear_templates(struct touchpad *tp);
+/**
+ * @ingroup api
+ *
+ * Set the interface for event handling. Only the callbacks up to and
+ * including struct touchpad_interface::pinch are used, all later ones
+ * are NULL. Use touchpad_set_interface_v2() instead.
+ *
  * @param tp A previously opened touchpad device
  * @param interface The callback interface
  */
 void touchpad_set_interface(struct touchpad *tp, const struct touchpad_interface *interface);
+/**
+ * @ingroup api
+ *
+ * Set the interface for event handling. The interface is copied, the
+ * caller doesn't need to keep it around. Callbacks beyond size are
+ * NULL.
+ *
+ * @param tp A previously opened touchpad device
+ * @param interface The callback interface
+ * @param size sizeof(*interface), the size of the interface the caller
+ *	  was built with
+ */
+void touchpad_set_interface_v2(struct touchpad *tp,
+			       const struct touchpad_interface *interface,
+			       size_t size);
 /**
  * @ingroup api
  *
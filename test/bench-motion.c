@@ -0,0 +1,208 @@
+/*
+ * Copyright © 2013 Red Hat, Inc.
+ *
+ * Permission to use, copy, modify, distribute, and sell this software and its
+ * documentation for any purpose is hereby granted without fee, provided that
+ * the above copyright notice appear in all copies and that both that copyright
+ * notice and this permission notice appear in supporting documentation, and
+ * that the name of the copyright holders not be used in advertising or
+ * publicity pertaining to distribution of the software without specific,
+ * written prior permission.  The copyright holders make no representations
+ * about the suitability of this software for any purpose.  It is provided "as
+ * is" without express or implied warranty.
+ *
+ * THE COPYRIGHT HOLDERS DISCLAIM ALL WARRANTIES WITH REGARD TO THIS SOFTWARE,
+ * INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS, IN NO
+ * EVENT SHALL THE COPYRIGHT HOLDERS BE LIABLE FOR ANY SPECIAL, INDIRECT OR
+ * CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE,
+ * DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER
+ * TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE
+ * OF THIS SOFTWARE.
+ */
+
+#if HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+/* Benchmark for the per-frame motion processing. This is not a test, it
+ * doesn't need a device and doesn't fail. It feeds synthetic frames for N
+ * simultaneous touches through the motion code and prints the number of
+ * frames per second, then the cost of each stage in the filter chain.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "touchpad-int.h"
+#include "touchpad-config.h"
+
+#define NFRAMES 2000000
+
+static double
+now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec/1e9;
+}
+
+static struct touchpad *
+bench_setup(int ntouches, unsigned int filters)
+{
+	struct touchpad *tp = zalloc(sizeof(*tp));
+	struct touch *t;
+
+	/* a synaptics-sized touchpad */
+	touchpad_geometry_set(tp, 1472, 5472, 75, 1408, 4448, 129);
+	touchpad_config_set_static_defaults(tp);
+	touchpad_config_set(tp, NULL,
+			    TOUCHPAD_CONFIG_MOTION_FILTERS, filters,
+			    TOUCHPAD_CONFIG_NONE);
+	tp->ntouches = ntouches;
+
+	touchpad_for_each_touch(tp, t) {
+		touchpad_history_reset(tp, t);
+		t->state = TOUCH_BEGIN;
+		t->x = 1000 + _i * 300;
+		t->y = 1000;
+	}
+
+	return tp;
+}
+
+/* With nmoving < ntouches, the other touches rest and only jitter */
+static void
+bench_next_frame(struct touchpad *tp, unsigned int frame, int nmoving)
+{
+	struct touch *t;
+
+	tp->ms = frame * 12;
+	touchpad_for_each_touch(tp, t) {
+		if (_i >= nmoving) {
+			t->x += (frame & 0x1) ? -1 : 1;
+		} else {
+			/* zig-zag so we don't overflow the coordinates */
+			t->x += (frame & 0x40) ? -13 : 13;
+			t->y += (frame & 0x20) ? -7 : 7;
+		}
+		t->dirty = true;
+	}
+}
+
+static int
+bench_end_frame(struct touchpad *tp)
+{
+	struct touch *t;
+	int sum = 0;
+
+	touchpad_for_each_touch(tp, t) {
+		sum += t->dx + t->dy;
+		if (!t->resting)
+			touchpad_history_push(t, t->x, t->y, tp->ms);
+		t->state = TOUCH_UPDATE;
+		t->dirty = false;
+	}
+
+	return sum;
+}
+
+static void
+bench_motion_moving(int ntouches, int nmoving, unsigned int filters)
+{
+	struct touchpad *tp = bench_setup(ntouches, filters);
+	double start, elapsed;
+	int sum = 0;
+
+	start = now();
+	for (unsigned int frame = 0; frame < NFRAMES; frame++) {
+		bench_next_frame(tp, frame, nmoving);
+		touchpad_motion_update(tp);
+		sum += bench_end_frame(tp);
+	}
+	elapsed = now() - start;
+
+	printf("%2d touches, %2d moving: %12.0f frames/s (checksum %d)\n",
+	       ntouches, nmoving, NFRAMES/elapsed, sum);
+
+	free(tp);
+}
+
+static void
+bench_motion(int ntouches, unsigned int filters)
+{
+	bench_motion_moving(ntouches, ntouches, filters);
+}
+
+/* Run each stage of the chain on its own, in chain order, so each stage
+ * sees the same input it would see in the full chain */
+static void
+bench_stages(int ntouches, unsigned int filters)
+{
+	struct touchpad *tp = bench_setup(ntouches, filters);
+	const struct motion_filter_chain *chain = &tp->filter;
+	double elapsed[MAX_MOTION_FILTERS] = {0};
+	struct touch *t;
+
+	for (unsigned int frame = 0; frame < NFRAMES; frame++) {
+		bench_next_frame(tp, frame, ntouches);
+
+		touchpad_for_each_touch(tp, t)
+			if (t->state == TOUCH_BEGIN)
+				touchpad_history_push(t, t->x, t->y, tp->ms);
+
+		for (int i = 0; i < chain->nstages; i++) {
+			double start = now();
+
+			touchpad_for_each_touch(tp, t)
+				chain->stages[i]->process(tp, t);
+			elapsed[i] += now() - start;
+		}
+
+		bench_end_frame(tp);
+	}
+
+	for (int i = 0; i < chain->nstages; i++)
+		printf("%2d touches: %-12s %8.1f ns/frame\n",
+		       ntouches, chain->stages[i]->name,
+		       elapsed[i] * 1e9/NFRAMES);
+
+	free(tp);
+}
+
+int main(int argc, char **argv) {
+	const unsigned int all = TOUCHPAD_MOTION_FILTER_JUMP |
+				 TOUCHPAD_MOTION_FILTER_HYSTERESIS |
+				 TOUCHPAD_MOTION_FILTER_AVERAGE;
+	const unsigned int tracker = TOUCHPAD_MOTION_FILTER_JUMP |
+				     TOUCHPAD_MOTION_FILTER_HYSTERESIS |
+				     TOUCHPAD_MOTION_FILTER_TRACKER;
+
+	printf("Default filter chain:\n");
+	bench_motion(2, all);
+	bench_motion(5, all);
+	bench_motion(10, all);
+
+	printf("No filters:\n");
+	bench_motion(2, TOUCHPAD_MOTION_FILTER_NONE);
+	bench_motion(5, TOUCHPAD_MOTION_FILTER_NONE);
+	bench_motion(10, TOUCHPAD_MOTION_FILTER_NONE);
+
+	printf("Hysteresis and tracker:\n");
+	bench_motion(2, tracker);
+	bench_motion(5, tracker);
+	bench_motion(10, tracker);
+
+	printf("Resting touches:\n");
+	bench_motion_moving(5, 1, all);
+	bench_motion_moving(10, 1, all);
+	bench_motion_moving(10, 2, all);
+
+	printf("Per stage:\n");
+	bench_stages(2, all);
+	bench_stages(10, all);
+	bench_stages(10, tracker);
+
+	return 0;
+}
@@ -0,0 +1,145 @@
+/*
+ * Copyright © 2013 Red Hat, Inc.
+ *
+ * Permission to use, copy, modify, distribute, and sell this software and its
+ * documentation for any purpose is hereby granted without fee, provided that
+ * the above copyright notice appear in all copies and that both that copyright
+ * notice and this permission notice appear in supporting documentation, and
+ * that the name of the copyright holders not be used in advertising or
+ * publicity pertaining to distribution of the software without specific,
+ * written prior permission.  The copyright holders make no representations
+ * about the suitability of this software for any purpose.  It is provided "as
+ * is" without express or implied warranty.
+ *
+ * THE COPYRIGHT HOLDERS DISCLAIM ALL WARRANTIES WITH REGARD TO THIS SOFTWARE,
+ * INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS, IN NO
+ * EVENT SHALL THE COPYRIGHT HOLDERS BE LIABLE FOR ANY SPECIAL, INDIRECT OR
+ * CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE,
+ * DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER
+ * TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE
+ * OF THIS SOFTWARE.
+ */
+
+#if HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+/* Benchmark for the symbol recognizer. This is not a test, it doesn't
+ * need a device and doesn't fail. It prints the cost of turning a
+ * finished stroke into a shape, then the cost of matching a shape
+ * against template sets of increasing size.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "touchpad-int.h"
+#include "touchpad-config.h"
+
+#define NMATCHES 20000000 /* templates compared per run */
+#define NSHAPES 200000
+
+static double
+now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec/1e9;
+}
+
+/* A deterministic random walk, so runs are comparable */
+static void
+random_path(unsigned int *seed, int *x, int *y, int npoints)
+{
+	x[0] = 0;
+	y[0] = 0;
+	for (int i = 1; i < npoints; i++) {
+		*seed = *seed * 1103515245 + 12345;
+		x[i] = x[i - 1] + (int)((*seed >> 16) % 21) - 10;
+		*seed = *seed * 1103515245 + 12345;
+		y[i] = y[i - 1] + (int)((*seed >> 16) % 21) - 10;
+	}
+}
+
+static void
+bench_shape(int npoints)
+{
+	int x[SYMBOL_MAX_PATH], y[SYMBOL_MAX_PATH];
+	struct symbol_shape shape;
+	unsigned int seed = 1;
+	double start, elapsed;
+	int sum = 0;
+
+	random_path(&seed, x, y, npoints);
+
+	start = now();
+	for (int i = 0; i < NSHAPES; i++) {
+		x[npoints - 1] = i & 0xff; /* don't let the compiler hoist it */
+		touchpad_symbol_shape(x, y, npoints, 1, &shape);
+		sum += shape.x[SYMBOL_POINTS/2];
+	}
+	elapsed = now() - start;
+
+	printf("%4d path points:  %8.1f ns/shape (checksum %d)\n",
+	       npoints, elapsed * 1e9/NSHAPES, sum);
+}
+
+static void
+bench_match(int ntemplates)
+{
+	struct touchpad *tp = zalloc(sizeof(*tp));
+	struct symbol_shape shape;
+	int x[16], y[16];
+	unsigned int seed = 1;
+	int iterations = NMATCHES/ntemplates;
+	double start, elapsed;
+	int sum = 0;
+
+	touchpad_geometry_set(tp, 1472, 5472, 75, 1408, 4448, 129);
+	touchpad_config_set_static_defaults(tp);
+	/* accept anything, so the best template is always tracked */
+	touchpad_config_set(tp, NULL,
+			    TOUCHPAD_CONFIG_SYMBOL_THRESHOLD, 100,
+			    TOUCHPAD_CONFIG_NONE);
+
+	for (int i = 0; i < ntemplates; i++) {
+		random_path(&seed, x, y, ARRAY_LENGTH(x));
+		touchpad_symbol_add_template(tp, i, x, y, ARRAY_LENGTH(x));
+	}
+
+	random_path(&seed, x, y, ARRAY_LENGTH(x));
+	touchpad_symbol_shape(x, y, ARRAY_LENGTH(x), 1, &shape);
+
+	start = now();
+	for (int i = 0; i < iterations; i++) {
+		shape.x[0] = i & 0xff; /* don't let the compiler hoist it */
+		sum += touchpad_symbol_match(tp, &shape);
+	}
+	elapsed = now() - start;
+
+	printf("%4d templates: %10.1f ns/match %6.2f ns/template (checksum %d)\n",
+	       ntemplates, elapsed * 1e9/iterations,
+	       elapsed * 1e9/iterations/ntemplates, sum);
+
+	touchpad_symbol_free(tp);
+	free(tp);
+}
+
+int main(int argc, char **argv) {
+	printf("Stroke to shape:\n");
+	bench_shape(16);
+	bench_shape(SYMBOL_MAX_PATH/2);
+	bench_shape(SYMBOL_MAX_PATH);
+
+	printf("Matching, %d points per shape:\n", SYMBOL_POINTS);
+	bench_match(1);
+	bench_match(8);
+	bench_match(32);
+	bench_match(128);
+	bench_match(512);
+	bench_match(2048);
+
+	return 0;
+}
@@ -0,0 +1,221 @@
+/*
+ * Copyright © 2013 Red Hat, Inc.
+ *
+ * Permission to use, copy, modify, distribute, and sell this software and its
+ * documentation for any purpose is hereby granted without fee, provided that
+ * the above copyright notice appear in all copies and that both that copyright
+ * notice and this permission notice appear in supporting documentation, and
+ * that the name of the copyright holders not be used in advertising or
+ * publicity pertaining to distribution of the software without specific,
+ * written prior permission.  The copyright holders make no representations
+ * about the suitability of this software for any purpose.  It is provided "as
+ * is" without express or implied warranty.
+ *
+ * THE COPYRIGHT HOLDERS DISCLAIM ALL WARRANTIES WITH REGARD TO THIS SOFTWARE,
+ * INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS, IN NO
+ * EVENT SHALL THE COPYRIGHT HOLDERS BE LIABLE FOR ANY SPECIAL, INDIRECT OR
+ * CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE,
+ * DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER
+ * TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE
+ * OF THIS SOFTWARE.
+ */
+
+#if HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+/* Compares the motion filters on a replayed trace. This is not a test,
+ * it doesn't need a device and doesn't fail.
+ *
+ * The trace is synthetic so we know where the finger really was: a finger
+ * resting, then starting to move slowly, then moving fast and stopping
+ * abruptly, with sensor noise added to every sample. The "cursor" is the
+ * sum of the deltas. For each filter configuration it prints
+ * - the jitter: standard deviation of the cursor while the finger rests
+ * - the lag: how far behind the true position the cursor is while the
+ *   finger moves, in ms, for the slow and the fast movement. With
+ *   prediction, a negative lag is latency saved.
+ * - the error: RMS distance between the cursor and where the finger
+ *   really was (or for predictions, really will be) while it moves
+ * - the overshoot: how far the cursor went past the true position
+ *   after the finger stopped
+ * Configurations without a delta filter have the filtered position as
+ * cursor.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "touchpad-int.h"
+#include "touchpad-config.h"
+
+#define FRAME_MS 8
+#define NOISE 8 /* peak noise in device units */
+#define RES 75 /* units/mm, a typical synaptics */
+
+struct sample {
+	unsigned int ms;
+	double x; /* true position */
+	double speed; /* true speed in units/s */
+};
+
+/* A deterministic noise source, so runs are comparable */
+static int
+noise(unsigned int *seed)
+{
+	*seed = *seed * 1103515245 + 12345;
+	return (int)((*seed >> 16) % (2 * NOISE + 1)) - NOISE;
+}
+
+/* 1s rest, 1s slow movement, 0.5s fast movement, 0.5s rest */
+static int
+make_trace(struct sample *trace, int max)
+{
+	double x = 2000;
+	int n = 0;
+
+	for (unsigned int ms = 0; ms < 3000 && n < max; ms += FRAME_MS) {
+		double speed;
+
+		if (ms < 1000)
+			speed = 0;
+		else if (ms < 2000)
+			speed = 400; /* about 5mm/s */
+		else if (ms < 2500)
+			speed = 8000;
+		else
+			speed = 0;
+
+		x += speed * FRAME_MS/1000.0;
+		trace[n].ms = ms;
+		trace[n].x = x;
+		trace[n].speed = speed;
+		n++;
+	}
+
+	return n;
+}
+
+struct replay_config {
+	const char *name;
+	unsigned int filters;
+	int margin;
+	int min_cutoff;
+	int beta;
+	int prediction;
+};
+
+static void
+replay(const struct replay_config *config, const struct sample *trace, int n)
+{
+	struct touchpad *tp = zalloc(sizeof(*tp));
+	struct touch *t = touchpad_touch(tp, 0);
+	unsigned int seed = 1;
+	double rest_sum = 0, rest_sum2 = 0, lag_slow = 0, lag_fast = 0;
+	double error2 = 0, overshoot = 0;
+	int njitter = 0, nslow = 0, nfast = 0;
+	int cursor = lround(trace[0].x);
+	int ahead = 0; /* frames predicted */
+
+	touchpad_geometry_set(tp, 0, 100 * RES, RES, 0, 60 * RES, RES);
+	touchpad_config_set_static_defaults(tp);
+	touchpad_config_set(tp, NULL,
+			    TOUCHPAD_CONFIG_MOTION_FILTERS, config->filters,
+			    TOUCHPAD_CONFIG_HYSTERESIS_MARGIN, config->margin,
+			    TOUCHPAD_CONFIG_ADAPTIVE_MIN_CUTOFF, config->min_cutoff,
+			    TOUCHPAD_CONFIG_ADAPTIVE_BETA, config->beta,
+			    TOUCHPAD_CONFIG_PREDICTION_TIME, config->prediction,
+			    TOUCHPAD_CONFIG_NONE);
+	tp->ntouches = 1;
+	touchpad_history_reset(tp, t);
+	t->state = TOUCH_BEGIN;
+
+	if (config->filters & TOUCHPAD_MOTION_FILTER_PREDICT)
+		ahead = tp->config.prediction_time/FRAME_MS;
+
+	for (int i = 0; i < n; i++) {
+		double error, future;
+
+		tp->ms = trace[i].ms;
+		t->x = lround(trace[i].x) + noise(&seed);
+		t->y = 2000;
+		t->dirty = true;
+
+		touchpad_motion_update(tp);
+		cursor += t->dx;
+
+		error = trace[i].x - cursor;
+		future = trace[min(i + ahead, n - 1)].x - cursor;
+		/* let the filter settle before measuring the rest jitter */
+		if (trace[i].speed == 0 && trace[i].ms > 200 && trace[i].ms < 1000) {
+			rest_sum += cursor;
+			rest_sum2 += (double)cursor * cursor;
+			njitter++;
+		} else if (trace[i].speed == 0 && trace[i].ms > 1000) {
+			overshoot = max(overshoot, -error);
+		} else if (trace[i].speed > 0 && trace[i].speed < 1000) {
+			lag_slow += error * 1000/trace[i].speed;
+			error2 += future * future;
+			nslow++;
+		} else if (trace[i].speed > 0) {
+			lag_fast += error * 1000/trace[i].speed;
+			error2 += future * future;
+			nfast++;
+		}
+
+		touchpad_history_push(t, t->x, t->y, tp->ms);
+		t->state = TOUCH_UPDATE;
+		t->dirty = false;
+	}
+
+	rest_sum /= njitter;
+	printf("%-30s %6.2f  %7.2f  %7.2f  %7.2f  %7.2f\n",
+	       config->name,
+	       sqrt(rest_sum2/njitter - rest_sum * rest_sum),
+	       lag_slow/nslow, lag_fast/nfast,
+	       sqrt(error2/(nslow + nfast)), overshoot);
+
+	free(tp);
+}
+
+int main(int argc, char **argv) {
+	static struct sample trace[1000];
+	const unsigned int hyst = TOUCHPAD_MOTION_FILTER_HYSTERESIS;
+	const unsigned int adaptive = TOUCHPAD_MOTION_FILTER_ADAPTIVE;
+	const unsigned int tracker = TOUCHPAD_MOTION_FILTER_TRACKER;
+	const unsigned int predict = TOUCHPAD_MOTION_FILTER_PREDICT;
+	const int dflt = TOUCHPAD_CONFIG_USE_DEFAULT;
+	const struct replay_config configs[] = {
+		{ "none", TOUCHPAD_MOTION_FILTER_NONE, dflt, dflt, dflt, dflt },
+		{ "hysteresis, margin 55um", hyst, 55, dflt, dflt, dflt },
+		{ "hysteresis, margin 110um", hyst, 110, dflt, dflt, dflt },
+		{ "hysteresis, margin 220um", hyst, 220, dflt, dflt, dflt },
+		{ "adaptive", adaptive, dflt, dflt, dflt, dflt },
+		{ "adaptive, 500mHz", adaptive, dflt, 500, dflt, dflt },
+		{ "adaptive, 2000mHz", adaptive, dflt, 2000, dflt, dflt },
+		{ "adaptive, beta 400", adaptive, dflt, dflt, 400, dflt },
+		{ "adaptive, beta 3000", adaptive, dflt, dflt, 3000, dflt },
+		{ "hysteresis+tracker", hyst|tracker, dflt, dflt, dflt, dflt },
+		{ "adaptive+tracker", adaptive|tracker, dflt, dflt, dflt, dflt },
+		{ "hyst+tracker+predict 8ms", hyst|tracker|predict, dflt, dflt, dflt, 8 },
+		{ "hyst+tracker+predict 16ms", hyst|tracker|predict, dflt, dflt, dflt, 16 },
+		{ "hyst+tracker+predict 32ms", hyst|tracker|predict, dflt, dflt, dflt, 32 },
+		{ "adaptive+predict 16ms", adaptive|predict, dflt, dflt, dflt, 16 },
+		{ "adaptive+tracker+predict 16ms", adaptive|tracker|predict, dflt, dflt, dflt, 16 },
+	};
+	const struct replay_config *config;
+	int n = make_trace(trace, ARRAY_LENGTH(trace));
+
+	printf("%d frames at %dms, noise ±%d units at %d units/mm\n",
+	       n, FRAME_MS, NOISE, RES);
+	printf("%-30s %6s  %7s  %7s  %7s  %7s\n",
+	       "", "jitter", "slow", "fast", "error", "over-");
+	printf("%-30s %6s  %7s  %7s  %7s  %7s\n",
+	       "", "units", "lag ms", "lag ms", "units", "shoot");
+
+	ARRAY_FOR_EACH(configs, config)
+		replay(config, trace, n);
+
+	return 0;
+}
@@ -28,6 +28,7 @@
 #include <check.h>
 #include <errno.h>
 #include <assert.h>
+#include <unistd.h>
 
 #include "tptest.h"
 #include "touchpad-util.h"
@@ -254,6 +255,128 @@ START_TEST(right_click_whole_touchpad)
 }
 END_TEST
 
+START_TEST(thumb_two_finger_scroll)
+{
+	struct tptest_device *dev = tptest_current_device();
+	union tptest_event *e;
+	bool scrolled = false;
+
+	ck_assert_int_eq(touchpad_config_set(dev->touchpad, NULL,
+					     TOUCHPAD_CONFIG_THUMB_TIMEOUT, 20,
+					     TOUCHPAD_CONFIG_NONE), 0);
+
+	/* a thumb resting in the button area doesn't count as a third
+	   finger */
+	tptest_touch_down(dev, 0, 50, 95);
+	while (tptest_handle_events(dev))
+		;
+	usleep(50000);
+
+	tptest_touch_down(dev, 1, 40, 20);
+	tptest_touch_down(dev, 2, 50, 20);
+	tptest_touch_move_to(dev, 1, 40, 20, 40, 60, -1);
+	tptest_touch_move_to(dev, 2, 50, 20, 50, 60, -1);
+	tptest_touch_up(dev, 1);
+	tptest_touch_up(dev, 2);
+	tptest_touch_up(dev, 0);
+
+	while (tptest_handle_events(dev))
+		;
+
+	ARRAY_FOR_EACH(dev->events, e) {
+		if (e->type == EVTYPE_NONE)
+			break;
+		if (e->type == EVTYPE_SCROLL && tptest_scroll_event(e)->units > 0)
+			scrolled = true;
+	}
+
+	ck_assert(scrolled);
+}
+END_TEST
+
+START_TEST(thumb_right_click)
+{
+	struct tptest_device *dev = tptest_current_device();
+	union tptest_event *e;
+	bool btn_down = false;
+
+	ck_assert_int_eq(touchpad_config_set(dev->touchpad, NULL,
+					     TOUCHPAD_CONFIG_THUMB_TIMEOUT, 20,
+					     TOUCHPAD_CONFIG_NONE), 0);
+
+	/* a thumb still clicks the soft button it rests on */
+	tptest_touch_down(dev, 0, 90, 95);
+	while (tptest_handle_events(dev))
+		;
+	usleep(50000);
+
+	tptest_touch_down(dev, 1, 30, 30);
+	tptest_touch_move_to(dev, 1, 30, 30, 40, 30, 5);
+	tptest_click(dev, true);
+	tptest_click(dev, false);
+	tptest_touch_up(dev, 1);
+	tptest_touch_up(dev, 0);
+
+	while (tptest_handle_events(dev))
+		;
+
+	ARRAY_FOR_EACH(dev->events, e) {
+		if (e->type == EVTYPE_NONE)
+			break;
+		if (e->type == EVTYPE_BUTTON && tptest_button_event(e)->is_press) {
+			ck_assert_int_eq(tptest_button_event(e)->button, BTN_RIGHT);
+			btn_down = true;
+		}
+	}
+
+	ck_assert(btn_down);
+}
+END_TEST
+
+START_TEST(thumb_restart_same_frame)
+{
+	struct tptest_device *dev = tptest_current_device();
+	union tptest_event *e;
+	bool moved = false;
+
+	ck_assert_int_eq(touchpad_config_set(dev->touchpad, NULL,
+					     TOUCHPAD_CONFIG_THUMB_TIMEOUT, 20,
+					     TOUCHPAD_CONFIG_NONE), 0);
+
+	tptest_touch_down(dev, 0, 50, 95);
+	while (tptest_handle_events(dev))
+		;
+	usleep(50000);
+	tptest_touch_move(dev, 0, 51, 95);
+	while (tptest_handle_events(dev))
+		;
+
+	/* the thumb lifts and a finger lands in the same frame, the
+	   finger is not a thumb */
+	tptest_event(dev, EV_ABS, ABS_MT_SLOT, 0);
+	tptest_event(dev, EV_ABS, ABS_MT_TRACKING_ID, -1);
+	tptest_event(dev, EV_ABS, ABS_MT_TRACKING_ID, 2000);
+	tptest_event(dev, EV_ABS, ABS_MT_POSITION_X, tptest_scale(dev, ABS_X, 40));
+	tptest_event(dev, EV_ABS, ABS_MT_POSITION_Y, tptest_scale(dev, ABS_Y, 40));
+	tptest_event(dev, EV_SYN, SYN_REPORT, 0);
+
+	tptest_touch_move_to(dev, 0, 40, 40, 60, 40, 10);
+	tptest_touch_up(dev, 0);
+
+	while (tptest_handle_events(dev))
+		;
+
+	ARRAY_FOR_EACH(dev->events, e) {
+		if (e->type == EVTYPE_NONE)
+			break;
+		if (e->type == EVTYPE_MOTION && tptest_motion_event(e)->x > 0)
+			moved = true;
+	}
+
+	ck_assert(moved);
+}
+END_TEST
+
 int main(int argc, char **argv) {
 	tptest_add("buttons_left_click", left_click_generic, TOUCHPAD_ALL_DEVICES);
 	tptest_add("buttons_left_click", left_click_in_area, TOUCHPAD_ALL_MT_DEVICES);
@@ -263,5 +386,10 @@ int main(int argc, char **argv) {
 	tptest_add("buttons_right_click", right_click_in_area_with_lbtn, TOUCHPAD_ALL_MT_DEVICES);
 	tptest_add("buttons_right_click", right_click_whole_touchpad, TOUCHPAD_ALL_MT_DEVICES);
 
+	/* needs three slots */
+	tptest_add("buttons_thumb", thumb_two_finger_scroll, TOUCHPAD_BCM5974);
+	tptest_add("buttons_thumb", thumb_right_click, TOUCHPAD_ALL_MT_DEVICES);
+	tptest_add("buttons_thumb", thumb_restart_same_frame, TOUCHPAD_ALL_MT_DEVICES);
+
 	return tptest_run(argc, argv);
 }
@@ -218,14 +218,170 @@ START_TEST(config_buttons_set_get)
 }
 END_TEST
 
+START_TEST(config_motion_filters)
+{
+	struct tptest_device *dev = tptest_current_device();
+	enum touchpad_config_error error;
+	enum touchpad_config_parameter p = TOUCHPAD_CONFIG_MOTION_FILTERS;
+	int value;
+
+	ck_assert_int_eq(touchpad_config_set(dev->touchpad, &error, p, 0x80,
+					     TOUCHPAD_CONFIG_NONE), 1);
+	ck_assert_int_eq(error, TOUCHPAD_CONFIG_ERROR_VALUE_INVALID);
+
+	ck_assert_int_eq(touchpad_config_set(dev->touchpad, &error,
+					     p, TOUCHPAD_MOTION_FILTER_NONE,
+					     TOUCHPAD_CONFIG_NONE), 0);
+	ck_assert_int_eq(touchpad_config_get(dev->touchpad, p, &value, TOUCHPAD_CONFIG_NONE), 0);
+	ck_assert_int_eq(value, TOUCHPAD_MOTION_FILTER_NONE);
+
+	ck_assert_int_eq(touchpad_config_set(dev->touchpad, &error,
+					     p, TOUCHPAD_MOTION_FILTER_AVERAGE,
+					     TOUCHPAD_CONFIG_NONE), 0);
+	ck_assert_int_eq(touchpad_config_get(dev->touchpad, p, &value, TOUCHPAD_CONFIG_NONE), 0);
+	ck_assert_int_eq(value, TOUCHPAD_MOTION_FILTER_AVERAGE);
+
+	ck_assert_int_eq(touchpad_config_set(dev->touchpad, &error,
+					     p, TOUCHPAD_CONFIG_USE_DEFAULT,
+					     TOUCHPAD_CONFIG_NONE), 0);
+	ck_assert_int_eq(touchpad_config_get(dev->touchpad, p, &value, TOUCHPAD_CONFIG_NONE), 0);
+	ck_assert_int_eq(value, TOUCHPAD_MOTION_FILTER_JUMP|TOUCHPAD_MOTION_FILTER_HYSTERESIS|TOUCHPAD_MOTION_FILTER_AVERAGE);
+
+	ck_assert_int_eq(touchpad_config_set(dev->touchpad, &error,
+					     TOUCHPAD_CONFIG_HYSTERESIS_MARGIN, -1,
+					     TOUCHPAD_CONFIG_NONE), 1);
+	ck_assert_int_eq(error, TOUCHPAD_CONFIG_ERROR_VALUE_TOO_LOW);
+
+	/* hysteresis and adaptive are mutually exclusive */
+	ck_assert_int_eq(touchpad_config_set(dev->touchpad, &error,
+					     p, TOUCHPAD_MOTION_FILTER_HYSTERESIS|TOUCHPAD_MOTION_FILTER_ADAPTIVE,
+					     TOUCHPAD_CONFIG_NONE), 1);
+	ck_assert_int_eq(error, TOUCHPAD_CONFIG_ERROR_VALUE_INVALID);
+	ck_assert_int_eq(touchpad_config_set(dev->touchpad, &error,
+					     p, TOUCHPAD_MOTION_FILTER_ADAPTIVE|TOUCHPAD_MOTION_FILTER_AVERAGE,
+					     TOUCHPAD_CONFIG_ADAPTIVE_MIN_CUTOFF, 500,
+					     TOUCHPAD_CONFIG_ADAPTIVE_BETA, 0,
+					     TOUCHPAD_CONFIG_NONE), 0);
+	ck_assert_int_eq(touchpad_config_set(dev->touchpad, &error,
+					     TOUCHPAD_CONFIG_ADAPTIVE_MIN_CUTOFF, 0,
+					     TOUCHPAD_CONFIG_NONE), 1);
+	ck_assert_int_eq(error, TOUCHPAD_CONFIG_ERROR_VALUE_TOO_LOW);
+
+	/* average and tracker are mutually exclusive */
+	ck_assert_int_eq(touchpad_config_set(dev->touchpad, &error,
+					     p, TOUCHPAD_MOTION_FILTER_AVERAGE|TOUCHPAD_MOTION_FILTER_TRACKER,
+					     TOUCHPAD_CONFIG_NONE), 1);
+	ck_assert_int_eq(error, TOUCHPAD_CONFIG_ERROR_VALUE_INVALID);
+	ck_assert_int_eq(touchpad_config_set(dev->touchpad, &error,
+					     p, TOUCHPAD_MOTION_FILTER_HYSTERESIS|TOUCHPAD_MOTION_FILTER_TRACKER,
+					     TOUCHPAD_CONFIG_TRACKER_ALPHA, 1000,
+					     TOUCHPAD_CONFIG_TRACKER_BETA, 0,
+					     TOUCHPAD_CONFIG_NONE), 0);
+	ck_assert_int_eq(touchpad_config_set(dev->touchpad, &error,
+					     TOUCHPAD_CONFIG_TRACKER_ALPHA, 1001,
+					     TOUCHPAD_CONFIG_NONE), 1);
+	ck_assert_int_eq(error, TOUCHPAD_CONFIG_ERROR_VALUE_TOO_HIGH);
+
+	ck_assert_int_eq(touchpad_config_set(dev->touchpad, &error,
+					     p, TOUCHPAD_MOTION_FILTER_TRACKER|TOUCHPAD_MOTION_FILTER_PREDICT,
+					     TOUCHPAD_CONFIG_PREDICTION_TIME, 20,
+					     TOUCHPAD_CONFIG_NONE), 0);
+	ck_assert_int_eq(touchpad_config_set(dev->touchpad, &error,
+					     TOUCHPAD_CONFIG_PREDICTION_TIME, 101,
+					     TOUCHPAD_CONFIG_NONE), 1);
+	ck_assert_int_eq(error, TOUCHPAD_CONFIG_ERROR_VALUE_TOO_HIGH);
+}
+END_TEST
+
+START_TEST(config_set_get_distances)
+{
+	struct tptest_device *dev = tptest_current_device();
+	enum touchpad_config_error error;
+	int timeout, threshold, vdelta, hdelta;
+
+	ck_assert_int_eq(touchpad_config_get(dev->touchpad,
+					     TOUCHPAD_CONFIG_TAP_TIMEOUT, &timeout,
+					     TOUCHPAD_CONFIG_NONE), 0);
+
+	/* distances are in µm, independent of the device */
+	ck_assert_int_eq(touchpad_config_set(dev->touchpad, &error,
+					     TOUCHPAD_CONFIG_TAP_MOVE_THRESHOLD, 1000,
+					     TOUCHPAD_CONFIG_SCROLL_DELTA_VERT, 2000,
+					     TOUCHPAD_CONFIG_SCROLL_DELTA_HORIZ, 3000,
+					     TOUCHPAD_CONFIG_NONE), 0);
+	ck_assert_int_eq(touchpad_config_get(dev->touchpad,
+					     TOUCHPAD_CONFIG_TAP_MOVE_THRESHOLD, &threshold,
+					     TOUCHPAD_CONFIG_SCROLL_DELTA_VERT, &vdelta,
+					     TOUCHPAD_CONFIG_SCROLL_DELTA_HORIZ, &hdelta,
+					     TOUCHPAD_CONFIG_NONE), 0);
+	ck_assert_int_eq(threshold, 1000);
+	ck_assert_int_eq(vdelta, 2000);
+	ck_assert_int_eq(hdelta, 3000);
+
+	/* the move threshold doesn't touch the tap timeout */
+	ck_assert_int_eq(touchpad_config_get(dev->touchpad,
+					     TOUCHPAD_CONFIG_TAP_TIMEOUT, &threshold,
+					     TOUCHPAD_CONFIG_NONE), 0);
+	ck_assert_int_eq(threshold, timeout);
+
+	ck_assert_int_eq(touchpad_config_set(dev->touchpad, &error,
+					     TOUCHPAD_CONFIG_SCROLL_DELTA_VERT, 0,
+					     TOUCHPAD_CONFIG_NONE), 1);
+	ck_assert_int_eq(error, TOUCHPAD_CONFIG_ERROR_VALUE_TOO_LOW);
+	ck_assert_int_eq(touchpad_config_set(dev->touchpad, &error,
+					     TOUCHPAD_CONFIG_TAP_MOVE_THRESHOLD, -1,
+					     TOUCHPAD_CONFIG_NONE), 1);
+	ck_assert_int_eq(error, TOUCHPAD_CONFIG_ERROR_VALUE_TOO_LOW);
+}
+END_TEST
+
+START_TEST(config_set_get_qualify)
+{
+	struct tptest_device *dev = tptest_current_device();
+	enum touchpad_config_error error;
+	int high, low, palm;
+
+	ck_assert_int_eq(touchpad_config_set(dev->touchpad, &error,
+					     TOUCHPAD_CONFIG_PRESSURE_HIGH, 20,
+					     TOUCHPAD_CONFIG_PRESSURE_LOW, 15,
+					     TOUCHPAD_CONFIG_PALM_SIZE, 20000,
+					     TOUCHPAD_CONFIG_NONE), 0);
+	ck_assert_int_eq(touchpad_config_get(dev->touchpad,
+					     TOUCHPAD_CONFIG_PRESSURE_HIGH, &high,
+					     TOUCHPAD_CONFIG_PRESSURE_LOW, &low,
+					     TOUCHPAD_CONFIG_PALM_SIZE, &palm,
+					     TOUCHPAD_CONFIG_NONE), 0);
+	ck_assert_int_eq(high, 20);
+	ck_assert_int_eq(low, 15);
+	ck_assert_int_eq(palm, 20000);
+
+	ck_assert_int_eq(touchpad_config_set(dev->touchpad, &error,
+					     TOUCHPAD_CONFIG_PRESSURE_HIGH, 101,
+					     TOUCHPAD_CONFIG_NONE), 1);
+	ck_assert_int_eq(error, TOUCHPAD_CONFIG_ERROR_VALUE_TOO_HIGH);
+	ck_assert_int_eq(touchpad_config_set(dev->touchpad, &error,
+					     TOUCHPAD_CONFIG_PRESSURE_LOW, -1,
+					     TOUCHPAD_CONFIG_NONE), 1);
+	ck_assert_int_eq(error, TOUCHPAD_CONFIG_ERROR_VALUE_TOO_LOW);
+	ck_assert_int_eq(touchpad_config_set(dev->touchpad, &error,
+					     TOUCHPAD_CONFIG_PALM_SIZE, -1,
+					     TOUCHPAD_CONFIG_NONE), 1);
+	ck_assert_int_eq(error, TOUCHPAD_CONFIG_ERROR_VALUE_TOO_LOW);
+}
+END_TEST
+
 int main(int argc, char **argv) {
 	tptest_add("config_get", config_get, TOUCHPAD_ALL_DEVICES);
 	tptest_add("config_get", config_get_invalid, TOUCHPAD_ALL_DEVICES);
 	tptest_add("config_get", config_get_empty, TOUCHPAD_ALL_DEVICES);
 	tptest_add("config_set", config_set_tap_enabled, TOUCHPAD_ALL_DEVICES);
+	tptest_add("config_set", config_set_get_distances, TOUCHPAD_ALL_DEVICES);
+	tptest_add("config_set", config_set_get_qualify, TOUCHPAD_ALL_DEVICES);
 
 	tptest_add("config_buttons", config_buttons_get_defaults, TOUCHPAD_ALL_DEVICES);
 	tptest_add("config_buttons", config_buttons_set_invalid, TOUCHPAD_ALL_DEVICES);
 	tptest_add("config_buttons", config_buttons_set_get, TOUCHPAD_ALL_DEVICES);
+
+	tptest_add("config_motion", config_motion_filters, TOUCHPAD_ALL_DEVICES);
 	return tptest_run(argc, argv);
 }
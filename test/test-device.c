@@ -63,9 +63,31 @@ START_TEST(device_change_fd)
 }
 END_TEST
 
+START_TEST(device_geometry)
+{
+	struct tptest_device *dev = tptest_current_device();
+	int min, max, res;
+
+	ck_assert_int_eq(touchpad_get_min_max(dev->touchpad, ABS_X, &min, &max, &res), 0);
+	ck_assert_int_eq(min, libevdev_get_abs_minimum(dev->evdev, ABS_X));
+	ck_assert_int_eq(max, libevdev_get_abs_maximum(dev->evdev, ABS_X));
+	/* estimated if the device doesn't have one */
+	ck_assert_int_gt(res, 0);
+	if (libevdev_get_abs_resolution(dev->evdev, ABS_X) > 0)
+		ck_assert_int_eq(res, libevdev_get_abs_resolution(dev->evdev, ABS_X));
+
+	/* same axis, whether the device has MT or not */
+	ck_assert_int_eq(touchpad_get_min_max(dev->touchpad, ABS_MT_POSITION_Y, &min, &max, &res), 0);
+	ck_assert_int_eq(min, libevdev_get_abs_minimum(dev->evdev, ABS_Y));
+	ck_assert_int_eq(max, libevdev_get_abs_maximum(dev->evdev, ABS_Y));
+	ck_assert_int_gt(res, 0);
+}
+END_TEST
+
 int main(int argc, char **argv) {
 	tptest_add("device_open", device_open_invalid_device, TOUCHPAD_NO_DEVICE);
 	tptest_add("device_change_fd", device_change_fd, TOUCHPAD_ALL_DEVICES);
+	tptest_add("device_geometry", device_geometry, TOUCHPAD_ALL_DEVICES);
 
 	return tptest_run(argc, argv);
 }
@@ -27,6 +27,8 @@
 #include <check.h>
 #include <errno.h>
 #include <assert.h>
+#include <string.h>
+#include <unistd.h>
 
 #include "tptest.h"
 #include "touchpad-util.h"
@@ -93,6 +95,247 @@ START_TEST(events_exceed_max_touches)
 }
 END_TEST
 
+static void
+clear_events(struct tptest_device *dev)
+{
+	memset(dev->events, 0, sizeof(dev->events));
+	dev->idx = 0;
+}
+
+START_TEST(events_motion_idle_gap)
+{
+	struct tptest_device *dev = tptest_current_device();
+	union tptest_event *e;
+	int max_dx = 0;
+
+	/* the timestamps are taken when the events are written, move at
+	   a steady rate so the frame period is known */
+	tptest_touch_down(dev, 0, 20, 50);
+	for (int i = 1; i <= 15; i++) {
+		usleep(10000);
+		tptest_touch_move(dev, 0, 20 + i, 50);
+	}
+	while (tptest_handle_events(dev))
+		;
+
+	ARRAY_FOR_EACH(dev->events, e) {
+		if (e->type == EVTYPE_NONE)
+			break;
+		if (e->type == EVTYPE_MOTION)
+			max_dx = max(max_dx, tptest_motion_event(e)->x);
+	}
+	ck_assert_int_gt(max_dx, 0);
+	clear_events(dev);
+
+	/* the device goes quiet, then the finger moves on at the same
+	   rate. The first frame after the gap must not jump. */
+	usleep(300000);
+	tptest_touch_move(dev, 0, 36, 50);
+	while (tptest_handle_events(dev))
+		;
+
+	ARRAY_FOR_EACH(dev->events, e) {
+		if (e->type == EVTYPE_NONE)
+			break;
+		if (e->type == EVTYPE_MOTION)
+			ck_assert_int_le(tptest_motion_event(e)->x, max_dx);
+	}
+
+	tptest_touch_up(dev, 0);
+	while (tptest_handle_events(dev))
+		;
+}
+END_TEST
+
+static int
+count_events(struct tptest_device *dev, enum tptest_event_type type)
+{
+	union tptest_event *e;
+	int count = 0;
+
+	ARRAY_FOR_EACH(dev->events, e) {
+		if (e->type == EVTYPE_NONE)
+			break;
+		if (e->type == type)
+			count++;
+	}
+
+	return count;
+}
+
+static void
+set_pressure(struct tptest_device *dev, unsigned int slot, int pressure)
+{
+	tptest_event(dev, EV_ABS, ABS_MT_SLOT, slot);
+	tptest_event(dev, EV_ABS, ABS_MT_PRESSURE, pressure);
+	tptest_event(dev, EV_SYN, SYN_REPORT, 0);
+}
+
+/**
+ * Enable the pressure thresholds and return the pressure between them
+ */
+static int
+enable_pressure(struct tptest_device *dev, int high, int low)
+{
+	int min, max;
+
+	ck_assert_int_eq(touchpad_config_set(dev->touchpad, NULL,
+					     TOUCHPAD_CONFIG_PRESSURE_HIGH, high,
+					     TOUCHPAD_CONFIG_PRESSURE_LOW, low,
+					     TOUCHPAD_CONFIG_NONE), 0);
+
+	min = libevdev_get_abs_minimum(dev->evdev, ABS_MT_PRESSURE);
+	max = libevdev_get_abs_maximum(dev->evdev, ABS_MT_PRESSURE);
+
+	return min + (max - min) * (high + low)/200;
+}
+
+static void
+touch_down_pressure(struct tptest_device *dev, unsigned int slot,
+		    int x, int y, int pressure)
+{
+	tptest_event(dev, EV_ABS, ABS_MT_SLOT, slot);
+	tptest_event(dev, EV_ABS, ABS_MT_TRACKING_ID, 1000 + slot);
+	tptest_event(dev, EV_ABS, ABS_MT_POSITION_X, tptest_scale(dev, ABS_X, x));
+	tptest_event(dev, EV_ABS, ABS_MT_POSITION_Y, tptest_scale(dev, ABS_Y, y));
+	tptest_event(dev, EV_ABS, ABS_MT_PRESSURE, pressure);
+	tptest_event(dev, EV_KEY, BTN_TOOL_FINGER, 1);
+	tptest_event(dev, EV_KEY, BTN_TOUCH, 1);
+	tptest_event(dev, EV_SYN, SYN_REPORT, 0);
+}
+
+START_TEST(events_pressure_default)
+{
+	struct tptest_device *dev = tptest_current_device();
+
+	/* by default the pressure isn't checked, a touch without any
+	   moves the pointer */
+	touch_down_pressure(dev, 0, 20, 20, 0);
+	tptest_touch_move_to(dev, 0, 20, 20, 40, 20, 10);
+	tptest_touch_up(dev, 0);
+
+	while (tptest_handle_events(dev))
+		;
+
+	ck_assert_int_gt(count_events(dev, EVTYPE_MOTION), 0);
+}
+END_TEST
+
+START_TEST(events_light_touch_ignored)
+{
+	struct tptest_device *dev = tptest_current_device();
+	int high = 20, low = 15;
+
+	enable_pressure(dev, high, low);
+
+	/* a touch below the pressure threshold neither taps nor moves */
+	touch_down_pressure(dev, 0, 20, 20, 1);
+	tptest_touch_move_to(dev, 0, 20, 20, 40, 20, 10);
+	tptest_touch_up(dev, 0);
+
+	while (tptest_handle_events(dev))
+		;
+
+	ck_assert_int_eq(count_events(dev, EVTYPE_MOTION), 0);
+	ck_assert_int_eq(count_events(dev, EVTYPE_TAP), 0);
+}
+END_TEST
+
+START_TEST(events_pressure_hysteresis)
+{
+	struct tptest_device *dev = tptest_current_device();
+	int min = libevdev_get_abs_minimum(dev->evdev, ABS_MT_PRESSURE);
+	int max = libevdev_get_abs_maximum(dev->evdev, ABS_MT_PRESSURE);
+	int between = enable_pressure(dev, 20, 15);
+	int nmotion;
+
+	touch_down_pressure(dev, 0, 20, 20, max);
+	tptest_touch_move_to(dev, 0, 20, 20, 30, 20, 5);
+
+	/* between the thresholds, the touch stays down */
+	set_pressure(dev, 0, between);
+	tptest_touch_move_to(dev, 0, 30, 20, 40, 20, 5);
+	while (tptest_handle_events(dev))
+		;
+	nmotion = count_events(dev, EVTYPE_MOTION);
+	ck_assert_int_gt(nmotion, 0);
+
+	/* below the low threshold it ends */
+	set_pressure(dev, 0, min);
+	tptest_touch_move_to(dev, 0, 40, 20, 60, 20, 5);
+	tptest_touch_up(dev, 0);
+	while (tptest_handle_events(dev))
+		;
+	ck_assert_int_eq(count_events(dev, EVTYPE_MOTION), nmotion);
+}
+END_TEST
+
+static void
+touch_down_major(struct tptest_device *dev, unsigned int slot,
+		 int x, int y, int major)
+{
+	tptest_event(dev, EV_ABS, ABS_MT_SLOT, slot);
+	tptest_event(dev, EV_ABS, ABS_MT_TRACKING_ID, 1000 + slot);
+	tptest_event(dev, EV_ABS, ABS_MT_POSITION_X, tptest_scale(dev, ABS_X, x));
+	tptest_event(dev, EV_ABS, ABS_MT_POSITION_Y, tptest_scale(dev, ABS_Y, y));
+	tptest_event(dev, EV_ABS, ABS_MT_TOUCH_MAJOR, major);
+	tptest_event(dev, EV_KEY, BTN_TOOL_FINGER, 1);
+	tptest_event(dev, EV_KEY, BTN_TOUCH, 1);
+	tptest_event(dev, EV_SYN, SYN_REPORT, 0);
+}
+
+START_TEST(events_palm_default)
+{
+	struct tptest_device *dev = tptest_current_device();
+	int max = libevdev_get_abs_maximum(dev->evdev, ABS_MT_TOUCH_MAJOR);
+
+	/* by default the size isn't checked, even the largest contact
+	   moves the pointer */
+	touch_down_major(dev, 0, 20, 20, max);
+	tptest_touch_move_to(dev, 0, 20, 20, 40, 20, 10);
+	tptest_touch_up(dev, 0);
+
+	while (tptest_handle_events(dev))
+		;
+
+	ck_assert_int_gt(count_events(dev, EVTYPE_MOTION), 0);
+}
+END_TEST
+
+START_TEST(events_palm_ignored)
+{
+	struct tptest_device *dev = tptest_current_device();
+	int res = libevdev_get_abs_resolution(dev->evdev, ABS_MT_TOUCH_MAJOR);
+
+	ck_assert_int_gt(res, 0);
+	ck_assert_int_eq(touchpad_config_set(dev->touchpad, NULL,
+					     TOUCHPAD_CONFIG_PALM_SIZE, 20000,
+					     TOUCHPAD_CONFIG_NONE), 0);
+
+	/* 25mm across is a palm, the size is in units of the touch major
+	   axis, not of the x axis */
+	touch_down_major(dev, 0, 20, 20, 25 * res);
+	tptest_touch_move_to(dev, 0, 20, 20, 40, 20, 10);
+	tptest_touch_up(dev, 0);
+
+	while (tptest_handle_events(dev))
+		;
+
+	ck_assert_int_eq(count_events(dev, EVTYPE_MOTION), 0);
+	ck_assert_int_eq(count_events(dev, EVTYPE_TAP), 0);
+
+	/* 10mm is a finger */
+	touch_down_major(dev, 0, 20, 20, 10 * res);
+	tptest_touch_move_to(dev, 0, 20, 20, 40, 20, 10);
+	tptest_touch_up(dev, 0);
+
+	while (tptest_handle_events(dev))
+		;
+
+	ck_assert_int_gt(count_events(dev, EVTYPE_MOTION), 0);
+}
+END_TEST
+
 int main(int argc, char **argv) {
 	tptest_add("events_invalid_touches", events_EV_SYN_only, TOUCHPAD_ALL_DEVICES);
 	tptest_add("events_invalid_touches", events_ABS_MT_TRACKING_ID_finishes, TOUCHPAD_ALL_DEVICES);
@@ -100,5 +343,14 @@ int main(int argc, char **argv) {
 
 	tptest_add("events_max_touches", events_exceed_max_touches, TOUCHPAD_BCM5974);
 
+	tptest_add("events_motion", events_motion_idle_gap, TOUCHPAD_ALL_DEVICES);
+
+	tptest_add("events_pressure", events_pressure_default, TOUCHPAD_SYNAPTICS_CLICKPAD);
+	tptest_add("events_pressure", events_light_touch_ignored, TOUCHPAD_SYNAPTICS_CLICKPAD);
+	tptest_add("events_pressure", events_pressure_hysteresis, TOUCHPAD_SYNAPTICS_CLICKPAD);
+
+	tptest_add("events_palm", events_palm_default, TOUCHPAD_BCM5974);
+	tptest_add("events_palm", events_palm_ignored, TOUCHPAD_BCM5974);
+
 	return tptest_run(argc, argv);
 }
@@ -0,0 +1,913 @@
+/*
+ * Copyright © 2013 Red Hat, Inc.
+ *
+ * Permission to use, copy, modify, distribute, and sell this software and its
+ * documentation for any purpose is hereby granted without fee, provided that
+ * the above copyright notice appear in all copies and that both that copyright
+ * notice and this permission notice appear in supporting documentation, and
+ * that the name of the copyright holders not be used in advertising or
+ * publicity pertaining to distribution of the software without specific,
+ * written prior permission.  The copyright holders make no representations
+ * about the suitability of this software for any purpose.  It is provided "as
+ * is" without express or implied warranty.
+ *
+ * THE COPYRIGHT HOLDERS DISCLAIM ALL WARRANTIES WITH REGARD TO THIS SOFTWARE,
+ * INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS, IN NO
+ * EVENT SHALL THE COPYRIGHT HOLDERS BE LIABLE FOR ANY SPECIAL, INDIRECT OR
+ * CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE,
+ * DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER
+ * TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE
+ * OF THIS SOFTWARE.
+ */
+
+#if HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <errno.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "tptest.h"
+#include "touchpad-util.h"
+#include "touchpad-config.h"
+
+START_TEST(gesture_pinch_out)
+{
+	struct tptest_device *dev = tptest_current_device();
+	union tptest_event *e;
+	double scale = 1.0;
+	int npinch = 0;
+
+	tptest_touch_down(dev, 0, 45, 50);
+	tptest_touch_down(dev, 1, 55, 50);
+	for (int i = 1; i <= 15; i++) {
+		tptest_touch_move(dev, 0, 45 - i, 50);
+		tptest_touch_move(dev, 1, 55 + i, 50);
+	}
+	tptest_touch_up(dev, 0);
+	tptest_touch_up(dev, 1);
+
+	while (tptest_handle_events(dev))
+		;
+
+	ARRAY_FOR_EACH(dev->events, e) {
+		if (e->type == EVTYPE_NONE)
+			break;
+		ck_assert_int_ne(e->type, EVTYPE_SCROLL);
+		ck_assert_int_ne(e->type, EVTYPE_ROTATE);
+		if (e->type == EVTYPE_PINCH) {
+			ck_assert_int_gt(tptest_pinch_event(e)->scale, 100);
+			scale *= tptest_pinch_event(e)->scale/100.0;
+			npinch++;
+		}
+	}
+
+	/* the distance grew from 10% to 40% of the width */
+	ck_assert_int_gt(npinch, 0);
+	ck_assert(scale > 3.6 && scale < 4.4);
+}
+END_TEST
+
+START_TEST(gesture_pinch_in)
+{
+	struct tptest_device *dev = tptest_current_device();
+	union tptest_event *e;
+	double scale = 1.0;
+	int npinch = 0;
+
+	tptest_touch_down(dev, 0, 30, 50);
+	tptest_touch_down(dev, 1, 70, 50);
+	for (int i = 1; i <= 15; i++) {
+		tptest_touch_move(dev, 0, 30 + i, 50);
+		tptest_touch_move(dev, 1, 70 - i, 50);
+	}
+	tptest_touch_up(dev, 0);
+	tptest_touch_up(dev, 1);
+
+	while (tptest_handle_events(dev))
+		;
+
+	ARRAY_FOR_EACH(dev->events, e) {
+		if (e->type == EVTYPE_NONE)
+			break;
+		ck_assert_int_ne(e->type, EVTYPE_SCROLL);
+		if (e->type == EVTYPE_PINCH) {
+			ck_assert_int_lt(tptest_pinch_event(e)->scale, 100);
+			scale *= tptest_pinch_event(e)->scale/100.0;
+			npinch++;
+		}
+	}
+
+	ck_assert_int_gt(npinch, 0);
+	ck_assert(scale > 0.22 && scale < 0.28);
+}
+END_TEST
+
+START_TEST(gesture_rotate)
+{
+	struct tptest_device *dev = tptest_current_device();
+	union tptest_event *e;
+	int degrees = 0;
+
+	/* a quarter turn clockwise */
+	tptest_touch_down(dev, 0, 40, 50);
+	tptest_touch_down(dev, 1, 60, 50);
+	for (int i = 1; i <= 10; i++) {
+		tptest_touch_move(dev, 0, 40 + i, 50 - i);
+		tptest_touch_move(dev, 1, 60 - i, 50 + i);
+	}
+	tptest_touch_up(dev, 0);
+	tptest_touch_up(dev, 1);
+
+	while (tptest_handle_events(dev))
+		;
+
+	ARRAY_FOR_EACH(dev->events, e) {
+		if (e->type == EVTYPE_NONE)
+			break;
+		ck_assert_int_ne(e->type, EVTYPE_SCROLL);
+		if (e->type == EVTYPE_ROTATE)
+			degrees += tptest_rotate_event(e)->degrees;
+	}
+
+	ck_assert_int_ge(degrees, 85);
+	ck_assert_int_le(degrees, 90);
+}
+END_TEST
+
+START_TEST(gesture_disabled)
+{
+	struct tptest_device *dev = tptest_current_device();
+	union tptest_event *e;
+
+	ck_assert_int_eq(touchpad_config_set(dev->touchpad, NULL,
+					     TOUCHPAD_CONFIG_GESTURES, TOUCHPAD_GESTURE_NONE,
+					     TOUCHPAD_CONFIG_NONE), 0);
+
+	tptest_touch_down(dev, 0, 45, 50);
+	tptest_touch_down(dev, 1, 55, 50);
+	for (int i = 1; i <= 15; i++) {
+		tptest_touch_move(dev, 0, 45 - i, 50 - i);
+		tptest_touch_move(dev, 1, 55 + i, 50 + i);
+	}
+	tptest_touch_up(dev, 0);
+	tptest_touch_up(dev, 1);
+
+	while (tptest_handle_events(dev))
+		;
+
+	ARRAY_FOR_EACH(dev->events, e) {
+		if (e->type == EVTYPE_NONE)
+			break;
+		ck_assert_int_ne(e->type, EVTYPE_PINCH);
+		ck_assert_int_ne(e->type, EVTYPE_ROTATE);
+	}
+}
+END_TEST
+
+/**
+ * Check the swipe events: a begin, updates and an end, all for the given
+ * number of fingers, and no pointer motion. The movement is summed up in
+ * dx/dy.
+ */
+static void
+check_swipe_events(struct tptest_device *dev, unsigned int fingers,
+		   int *dx, int *dy)
+{
+	union tptest_event *e;
+	bool began = false, ended = false;
+
+	*dx = 0;
+	*dy = 0;
+
+	ARRAY_FOR_EACH(dev->events, e) {
+		if (e->type == EVTYPE_NONE)
+			break;
+		ck_assert_int_ne(e->type, EVTYPE_MOTION);
+		switch (e->type) {
+			case EVTYPE_SWIPE_BEGIN:
+				ck_assert(!began);
+				began = true;
+				break;
+			case EVTYPE_SWIPE_UPDATE:
+				ck_assert(began && !ended);
+				*dx += tptest_swipe_event(e)->dx;
+				*dy += tptest_swipe_event(e)->dy;
+				break;
+			case EVTYPE_SWIPE_END:
+				ck_assert(began);
+				ended = true;
+				break;
+			default:
+				continue;
+		}
+		ck_assert_int_eq(tptest_swipe_event(e)->fingers, fingers);
+	}
+
+	ck_assert(began);
+	ck_assert(ended);
+}
+
+START_TEST(gesture_swipe_three_finger)
+{
+	struct tptest_device *dev = tptest_current_device();
+	int dx, dy;
+	int distance = tptest_scale(dev, ABS_X, 50) - tptest_scale(dev, ABS_X, 30);
+
+	tptest_touch_down(dev, 0, 30, 30);
+	tptest_touch_down(dev, 1, 40, 30);
+	tptest_touch_down(dev, 2, 50, 30);
+	for (int i = 1; i <= 20; i++) {
+		tptest_touch_move(dev, 0, 30 + i, 30);
+		tptest_touch_move(dev, 1, 40 + i, 30);
+		tptest_touch_move(dev, 2, 50 + i, 30);
+	}
+	tptest_touch_up(dev, 0);
+	tptest_touch_up(dev, 1);
+	tptest_touch_up(dev, 2);
+
+	while (tptest_handle_events(dev))
+		;
+
+	check_swipe_events(dev, 3, &dx, &dy);
+	ck_assert_int_le(dx, distance);
+	ck_assert_int_ge(dx, distance * 8/10);
+	ck_assert_int_eq(dy, 0);
+}
+END_TEST
+
+START_TEST(gesture_swipe_four_finger)
+{
+	struct tptest_device *dev = tptest_current_device();
+	int dx, dy;
+	int distance = tptest_scale(dev, ABS_Y, 70) - tptest_scale(dev, ABS_Y, 50);
+
+	for (int slot = 0; slot < 4; slot++)
+		tptest_touch_down(dev, slot, 30 + slot * 10, 70);
+	for (int i = 1; i <= 20; i++)
+		for (int slot = 0; slot < 4; slot++)
+			tptest_touch_move(dev, slot, 30 + slot * 10, 70 - i);
+	for (int slot = 0; slot < 4; slot++)
+		tptest_touch_up(dev, slot);
+
+	while (tptest_handle_events(dev))
+		;
+
+	check_swipe_events(dev, 4, &dx, &dy);
+	ck_assert_int_eq(dx, 0);
+	ck_assert_int_ge(dy, -distance);
+	ck_assert_int_le(dy, -distance * 8/10);
+}
+END_TEST
+
+START_TEST(gesture_swipe_no_callbacks)
+{
+	struct tptest_device *dev = tptest_current_device();
+	union tptest_event *e;
+
+	tptest_use_basic_interface(dev);
+
+	tptest_touch_down(dev, 0, 30, 30);
+	tptest_touch_down(dev, 1, 40, 30);
+	tptest_touch_down(dev, 2, 50, 30);
+	for (int i = 1; i <= 20; i++) {
+		tptest_touch_move(dev, 0, 30 + i, 30);
+		tptest_touch_move(dev, 1, 40 + i, 30);
+		tptest_touch_move(dev, 2, 50 + i, 30);
+	}
+	tptest_touch_up(dev, 0);
+	tptest_touch_up(dev, 1);
+	tptest_touch_up(dev, 2);
+
+	while (tptest_handle_events(dev))
+		;
+
+	ARRAY_FOR_EACH(dev->events, e) {
+		if (e->type == EVTYPE_NONE)
+			break;
+		ck_assert_int_ne(e->type, EVTYPE_SWIPE_BEGIN);
+		ck_assert_int_ne(e->type, EVTYPE_SWIPE_UPDATE);
+		ck_assert_int_ne(e->type, EVTYPE_SWIPE_END);
+	}
+}
+END_TEST
+
+START_TEST(gesture_swipe_v1_interface)
+{
+	struct tptest_device *dev = tptest_current_device();
+	union tptest_event *e;
+	int npinch = 0;
+
+	tptest_use_v1_interface(dev);
+
+	/* no swipe, the interface has no swipe callbacks */
+	tptest_touch_down(dev, 0, 30, 30);
+	tptest_touch_down(dev, 1, 40, 30);
+	tptest_touch_down(dev, 2, 50, 30);
+	for (int i = 1; i <= 20; i++) {
+		tptest_touch_move(dev, 0, 30 + i, 30);
+		tptest_touch_move(dev, 1, 40 + i, 30);
+		tptest_touch_move(dev, 2, 50 + i, 30);
+	}
+	tptest_touch_up(dev, 0);
+	tptest_touch_up(dev, 1);
+	tptest_touch_up(dev, 2);
+
+	/* but a pinch */
+	tptest_touch_down(dev, 0, 45, 50);
+	tptest_touch_down(dev, 1, 55, 50);
+	for (int i = 1; i <= 15; i++) {
+		tptest_touch_move(dev, 0, 45 - i, 50);
+		tptest_touch_move(dev, 1, 55 + i, 50);
+	}
+	tptest_touch_up(dev, 0);
+	tptest_touch_up(dev, 1);
+
+	while (tptest_handle_events(dev))
+		;
+
+	ARRAY_FOR_EACH(dev->events, e) {
+		if (e->type == EVTYPE_NONE)
+			break;
+		ck_assert_int_ne(e->type, EVTYPE_SWIPE_BEGIN);
+		ck_assert_int_ne(e->type, EVTYPE_SWIPE_UPDATE);
+		ck_assert_int_ne(e->type, EVTYPE_SWIPE_END);
+		if (e->type == EVTYPE_PINCH)
+			npinch++;
+	}
+	ck_assert_int_gt(npinch, 0);
+}
+END_TEST
+
+START_TEST(gesture_swipe_fake_touches)
+{
+	struct tptest_device *dev = tptest_current_device();
+	int dx, dy;
+
+	/* two tracked touches, the third finger only announced */
+	tptest_touch_down(dev, 0, 30, 30);
+	tptest_touch_down(dev, 1, 40, 30);
+	tptest_event(dev, EV_KEY, BTN_TOOL_TRIPLETAP, 1);
+	tptest_event(dev, EV_SYN, SYN_REPORT, 0);
+	for (int i = 1; i <= 20; i++) {
+		tptest_touch_move(dev, 0, 30 + i, 30);
+		tptest_touch_move(dev, 1, 40 + i, 30);
+	}
+	tptest_event(dev, EV_KEY, BTN_TOOL_TRIPLETAP, 0);
+	tptest_event(dev, EV_SYN, SYN_REPORT, 0);
+	tptest_touch_up(dev, 0);
+	tptest_touch_up(dev, 1);
+
+	while (tptest_handle_events(dev))
+		;
+
+	check_swipe_events(dev, 3, &dx, &dy);
+	ck_assert_int_gt(dx, 0);
+}
+END_TEST
+
+START_TEST(gesture_no_callbacks)
+{
+	struct tptest_device *dev = tptest_current_device();
+	union tptest_event *e;
+	bool scrolled = false;
+
+	tptest_use_basic_interface(dev);
+
+	/* without the callbacks, a pinch is nothing */
+	tptest_touch_down(dev, 0, 45, 50);
+	tptest_touch_down(dev, 1, 55, 50);
+	for (int i = 1; i <= 15; i++) {
+		tptest_touch_move(dev, 0, 45 - i, 50);
+		tptest_touch_move(dev, 1, 55 + i, 50);
+	}
+
+	/* and doesn't hold off a scroll */
+	for (int i = 1; i <= 15; i++) {
+		tptest_touch_move(dev, 0, 30, 50 + 2 * i);
+		tptest_touch_move(dev, 1, 70, 50 + 2 * i);
+	}
+	tptest_touch_up(dev, 0);
+	tptest_touch_up(dev, 1);
+
+	while (tptest_handle_events(dev))
+		;
+
+	ARRAY_FOR_EACH(dev->events, e) {
+		if (e->type == EVTYPE_NONE)
+			break;
+		ck_assert_int_ne(e->type, EVTYPE_PINCH);
+		ck_assert_int_ne(e->type, EVTYPE_ROTATE);
+		if (e->type == EVTYPE_SCROLL)
+			scrolled = true;
+	}
+
+	ck_assert(scrolled);
+}
+END_TEST
+
+/* A third finger during a two-finger scroll terminates the scroll first,
+ * the swipe can only begin after that */
+START_TEST(gesture_swipe_after_scroll)
+{
+	struct tptest_device *dev = tptest_current_device();
+	union tptest_event *e;
+	bool scroll_ended = false, swipe_began = false;
+
+	tptest_touch_down(dev, 0, 30, 30);
+	tptest_touch_down(dev, 1, 40, 30);
+	for (int i = 1; i <= 5; i++) {
+		tptest_touch_move(dev, 0, 30, 30 + i * 3);
+		tptest_touch_move(dev, 1, 40, 30 + i * 3);
+	}
+	tptest_touch_down(dev, 2, 50, 45);
+	for (int i = 1; i <= 10; i++) {
+		tptest_touch_move(dev, 0, 30, 45 + i * 2);
+		tptest_touch_move(dev, 1, 40, 45 + i * 2);
+		tptest_touch_move(dev, 2, 50, 45 + i * 2);
+	}
+	tptest_touch_up(dev, 0);
+	tptest_touch_up(dev, 1);
+	tptest_touch_up(dev, 2);
+
+	while (tptest_handle_events(dev))
+		;
+
+	ARRAY_FOR_EACH(dev->events, e) {
+		if (e->type == EVTYPE_NONE)
+			break;
+
+		switch (e->type) {
+			case EVTYPE_SCROLL:
+				ck_assert(!scroll_ended);
+				if (tptest_scroll_event(e)->units == 0.0)
+					scroll_ended = true;
+				break;
+			case EVTYPE_SWIPE_BEGIN:
+				ck_assert(scroll_ended);
+				swipe_began = true;
+				break;
+			default:
+				break;
+		}
+	}
+
+	ck_assert(scroll_ended);
+	ck_assert(swipe_began);
+}
+END_TEST
+
+static int
+enable_hold(struct tptest_device *dev)
+{
+	int gestures;
+	const int timeout = 100;
+
+	touchpad_config_get(dev->touchpad,
+			    TOUCHPAD_CONFIG_GESTURES, &gestures,
+			    TOUCHPAD_CONFIG_NONE);
+	ck_assert_int_eq(touchpad_config_set(dev->touchpad, NULL,
+					     TOUCHPAD_CONFIG_GESTURES, gestures | TOUCHPAD_GESTURE_HOLD,
+					     TOUCHPAD_CONFIG_HOLD_TIMEOUT, timeout,
+					     TOUCHPAD_CONFIG_NONE), 0);
+	return timeout;
+}
+
+START_TEST(gesture_hold)
+{
+	struct tptest_device *dev = tptest_current_device();
+	union tptest_event *e;
+	bool began = false, ended = false;
+	int timeout = enable_hold(dev);
+
+	tptest_touch_down(dev, 0, 50, 50);
+	tptest_handle_events(dev);
+	usleep(timeout * 2 * 1000);
+	tptest_handle_events(dev);
+	tptest_touch_up(dev, 0);
+	tptest_handle_events(dev);
+
+	ARRAY_FOR_EACH(dev->events, e) {
+		if (e->type == EVTYPE_NONE)
+			break;
+
+		switch (e->type) {
+			case EVTYPE_HOLD_BEGIN:
+				ck_assert(!began);
+				began = true;
+				break;
+			case EVTYPE_HOLD_END:
+				ck_assert(began);
+				ck_assert(!tptest_hold_event(e)->cancelled);
+				ended = true;
+				break;
+			default:
+				break;
+		}
+	}
+
+	ck_assert(began);
+	ck_assert(ended);
+}
+END_TEST
+
+START_TEST(gesture_hold_moved)
+{
+	struct tptest_device *dev = tptest_current_device();
+	union tptest_event *e;
+	int timeout = enable_hold(dev);
+
+	tptest_touch_down(dev, 0, 50, 50);
+	tptest_touch_move_to(dev, 0, 50, 50, 70, 50, 10);
+	tptest_handle_events(dev);
+	usleep(timeout * 2 * 1000);
+	tptest_handle_events(dev);
+	tptest_touch_up(dev, 0);
+	tptest_handle_events(dev);
+
+	ARRAY_FOR_EACH(dev->events, e) {
+		if (e->type == EVTYPE_NONE)
+			break;
+		ck_assert_int_ne(e->type, EVTYPE_HOLD_BEGIN);
+		ck_assert_int_ne(e->type, EVTYPE_HOLD_END);
+	}
+}
+END_TEST
+
+START_TEST(gesture_hold_no_callbacks)
+{
+	struct tptest_device *dev = tptest_current_device();
+	union tptest_event *e;
+	bool moved = false;
+	int timeout;
+
+	tptest_use_basic_interface(dev);
+	timeout = enable_hold(dev);
+
+	/* without the callbacks, the finger is just a pointer */
+	tptest_touch_down(dev, 0, 50, 50);
+	tptest_handle_events(dev);
+	usleep(timeout * 2 * 1000);
+	tptest_handle_events(dev);
+	tptest_touch_move_to(dev, 0, 50, 50, 70, 50, 10);
+	tptest_touch_up(dev, 0);
+	while (tptest_handle_events(dev))
+		;
+
+	ARRAY_FOR_EACH(dev->events, e) {
+		if (e->type == EVTYPE_NONE)
+			break;
+		ck_assert_int_ne(e->type, EVTYPE_HOLD_BEGIN);
+		ck_assert_int_ne(e->type, EVTYPE_HOLD_END);
+		if (e->type == EVTYPE_MOTION)
+			moved = true;
+	}
+
+	ck_assert(moved);
+}
+END_TEST
+
+START_TEST(gesture_hold_after_edge_scroll)
+{
+	struct tptest_device *dev = tptest_current_device();
+	union tptest_event *e;
+	bool scrolled = false, began = false, ended = false;
+	int timeout = enable_hold(dev);
+
+	ck_assert_int_eq(touchpad_config_set(dev->touchpad, NULL,
+					     TOUCHPAD_CONFIG_SCROLL_METHOD,
+					     TOUCHPAD_SCROLL_EDGE_VERTICAL,
+					     TOUCHPAD_CONFIG_NONE), 0);
+
+	/* the edge scroll cancels the first finger's hold and owns the
+	 * frame it lifts in */
+	tptest_touch_down(dev, 0, 99, 20);
+	tptest_touch_move_to(dev, 0, 99, 20, 99, 80, -1);
+	tptest_touch_up(dev, 0);
+	tptest_handle_events(dev);
+
+	/* the next finger still holds */
+	tptest_touch_down(dev, 0, 50, 50);
+	tptest_handle_events(dev);
+	usleep(timeout * 2 * 1000);
+	tptest_handle_events(dev);
+	tptest_touch_up(dev, 0);
+	tptest_handle_events(dev);
+
+	ARRAY_FOR_EACH(dev->events, e) {
+		if (e->type == EVTYPE_NONE)
+			break;
+
+		switch (e->type) {
+			case EVTYPE_SCROLL:
+				ck_assert(!began);
+				scrolled = true;
+				break;
+			case EVTYPE_HOLD_BEGIN:
+				ck_assert(scrolled);
+				ck_assert(!began);
+				began = true;
+				break;
+			case EVTYPE_HOLD_END:
+				ck_assert(began);
+				ck_assert(!tptest_hold_event(e)->cancelled);
+				ended = true;
+				break;
+			default:
+				break;
+		}
+	}
+
+	ck_assert(scrolled);
+	ck_assert(began);
+	ck_assert(ended);
+}
+END_TEST
+
+START_TEST(gesture_hold_after_scroll)
+{
+	struct tptest_device *dev = tptest_current_device();
+	union tptest_event *e;
+	bool scrolled = false, began = false;
+	int timeout = enable_hold(dev);
+
+	/* one finger rests while the other one scrolls */
+	tptest_touch_down(dev, 0, 30, 50);
+	tptest_touch_down(dev, 1, 50, 30);
+	tptest_touch_move_to(dev, 1, 50, 30, 50, 70, 10);
+	tptest_touch_up(dev, 1);
+	tptest_handle_events(dev);
+
+	/* the resting finger's next frame, well within the movement limit,
+	 * makes it a hold candidate again */
+	tptest_event(dev, EV_ABS, ABS_MT_SLOT, 0);
+	tptest_event(dev, EV_ABS, ABS_MT_POSITION_X, tptest_scale(dev, ABS_X, 30) + 1);
+	tptest_event(dev, EV_SYN, SYN_REPORT, 0);
+	tptest_handle_events(dev);
+	usleep(timeout * 2 * 1000);
+	tptest_handle_events(dev);
+	tptest_touch_up(dev, 0);
+	tptest_handle_events(dev);
+
+	ARRAY_FOR_EACH(dev->events, e) {
+		if (e->type == EVTYPE_NONE)
+			break;
+
+		switch (e->type) {
+			case EVTYPE_SCROLL:
+				ck_assert(!began);
+				scrolled = true;
+				break;
+			case EVTYPE_HOLD_BEGIN:
+				ck_assert(scrolled);
+				began = true;
+				break;
+			default:
+				break;
+		}
+	}
+
+	ck_assert(scrolled);
+	ck_assert(began);
+}
+END_TEST
+
+/* an L, a check mark and a horizontal line, in % of the touchpad */
+static const int L_x[] = { 20, 20, 60 }, L_y[] = { 10, 70, 70 };
+static const int check_x[] = { 20, 35, 70 }, check_y[] = { 40, 70, 10 };
+static const int line_x[] = { 20, 80 }, line_y[] = { 40, 40 };
+
+/**
+ * Convert a path in % of the touchpad to mm relative to its first point,
+ * so a template has the shape the path has on the touchpad
+ */
+static void
+symbol_path_mm(struct tptest_device *dev, const int *px, const int *py,
+	       int npoints, int *x, int *y)
+{
+	int xres, yres;
+
+	touchpad_get_min_max(dev->touchpad, ABS_X, NULL, NULL, &xres);
+	touchpad_get_min_max(dev->touchpad, ABS_Y, NULL, NULL, &yres);
+	for (int i = 0; i < npoints; i++) {
+		x[i] = (tptest_scale(dev, ABS_X, px[i]) - tptest_scale(dev, ABS_X, px[0]))/xres;
+		y[i] = (tptest_scale(dev, ABS_Y, py[i]) - tptest_scale(dev, ABS_Y, py[0]))/yres;
+	}
+}
+
+static void
+symbol_add_template(struct tptest_device *dev, int id,
+		    const int *px, const int *py, int npoints)
+{
+	int x[npoints], y[npoints];
+
+	symbol_path_mm(dev, px, py, npoints, x, y);
+	ck_assert_int_eq(touchpad_symbol_add_template(dev->touchpad, id, x, y, npoints), 0);
+}
+
+static void
+symbol_enable(struct tptest_device *dev)
+{
+	int gestures;
+
+	touchpad_config_get(dev->touchpad,
+			    TOUCHPAD_CONFIG_GESTURES, &gestures,
+			    TOUCHPAD_CONFIG_NONE);
+	ck_assert_int_eq(touchpad_config_set(dev->touchpad, NULL,
+					     TOUCHPAD_CONFIG_GESTURES, gestures | TOUCHPAD_GESTURE_SYMBOL,
+					     TOUCHPAD_CONFIG_NONE), 0);
+}
+
+static void
+symbol_trace(struct tptest_device *dev, const int *px, const int *py, int npoints)
+{
+	tptest_touch_down(dev, 0, px[0], py[0]);
+	for (int i = 1; i < npoints; i++)
+		tptest_touch_move_to(dev, 0, px[i - 1], py[i - 1], px[i], py[i], 5);
+	tptest_touch_up(dev, 0);
+
+	while (tptest_handle_events(dev))
+		;
+}
+
+/**
+ * @return the id of the only symbol event, or -1 if there was none
+ */
+static int
+symbol_event_id(struct tptest_device *dev)
+{
+	union tptest_event *e;
+	int id = -1;
+
+	ARRAY_FOR_EACH(dev->events, e) {
+		if (e->type == EVTYPE_NONE)
+			break;
+		if (e->type == EVTYPE_SYMBOL) {
+			ck_assert_int_eq(id, -1);
+			id = tptest_symbol_event(e)->id;
+		}
+	}
+
+	return id;
+}
+
+START_TEST(gesture_symbol)
+{
+	struct tptest_device *dev = tptest_current_device();
+
+	symbol_add_template(dev, 1, L_x, L_y, ARRAY_LENGTH(L_x));
+	symbol_add_template(dev, 2, check_x, check_y, ARRAY_LENGTH(check_x));
+	symbol_enable(dev);
+
+	symbol_trace(dev, L_x, L_y, ARRAY_LENGTH(L_x));
+	ck_assert_int_eq(symbol_event_id(dev), 1);
+}
+END_TEST
+
+START_TEST(gesture_symbol_no_match)
+{
+	struct tptest_device *dev = tptest_current_device();
+
+	symbol_add_template(dev, 1, L_x, L_y, ARRAY_LENGTH(L_x));
+	symbol_add_template(dev, 2, check_x, check_y, ARRAY_LENGTH(check_x));
+	symbol_enable(dev);
+
+	symbol_trace(dev, line_x, line_y, ARRAY_LENGTH(line_x));
+	ck_assert_int_eq(symbol_event_id(dev), -1);
+}
+END_TEST
+
+START_TEST(gesture_symbol_disabled)
+{
+	struct tptest_device *dev = tptest_current_device();
+
+	symbol_add_template(dev, 1, L_x, L_y, ARRAY_LENGTH(L_x));
+
+	symbol_trace(dev, L_x, L_y, ARRAY_LENGTH(L_x));
+	ck_assert_int_eq(symbol_event_id(dev), -1);
+}
+END_TEST
+
+START_TEST(gesture_symbol_no_callback)
+{
+	struct tptest_device *dev = tptest_current_device();
+	union tptest_event *e;
+	bool moved = false;
+
+	tptest_use_basic_interface(dev);
+	symbol_add_template(dev, 1, L_x, L_y, ARRAY_LENGTH(L_x));
+	symbol_enable(dev);
+
+	symbol_trace(dev, L_x, L_y, ARRAY_LENGTH(L_x));
+
+	ARRAY_FOR_EACH(dev->events, e) {
+		if (e->type == EVTYPE_NONE)
+			break;
+		ck_assert_int_ne(e->type, EVTYPE_SYMBOL);
+		if (e->type == EVTYPE_MOTION)
+			moved = true;
+	}
+
+	ck_assert(moved);
+}
+END_TEST
+
+/**
+ * Write a template file with the L as id 1 and the check mark as id 2.
+ * If truncate is nonzero, that many bytes are cut off the end.
+ */
+static void
+symbol_write_file(struct tptest_device *dev, char *path, int truncate)
+{
+	const struct {
+		int id;
+		const int *x, *y;
+		int npoints;
+	} templates[] = {
+		{ 1, L_x, L_y, ARRAY_LENGTH(L_x) },
+		{ 2, check_x, check_y, ARRAY_LENGTH(check_x) },
+	};
+	uint8_t data[64] = { 'T', 'P', 'S', 'Y', 1, 0, ARRAY_LENGTH(templates), 0 };
+	size_t size = 8;
+	int fd;
+
+	for (size_t i = 0; i < ARRAY_LENGTH(templates); i++) {
+		int x[8], y[8];
+
+		symbol_path_mm(dev, templates[i].x, templates[i].y,
+			       templates[i].npoints, x, y);
+		data[size++] = templates[i].id;
+		data[size++] = 0;
+		data[size++] = templates[i].npoints;
+		for (int p = 0; p < templates[i].npoints; p++) {
+			data[size++] = (int8_t)x[p];
+			data[size++] = (int8_t)y[p];
+		}
+	}
+
+	fd = mkstemp(path);
+	ck_assert_int_ge(fd, 0);
+	ck_assert_int_eq(write(fd, data, size - truncate), size - truncate);
+	close(fd);
+}
+
+START_TEST(gesture_symbol_load)
+{
+	struct tptest_device *dev = tptest_current_device();
+	char path[] = "/tmp/tptest-symbols-XXXXXX";
+
+	symbol_write_file(dev, path, 0);
+	ck_assert_int_eq(touchpad_symbol_load_templates(dev->touchpad, path), 0);
+	unlink(path);
+	symbol_enable(dev);
+
+	symbol_trace(dev, check_x, check_y, ARRAY_LENGTH(check_x));
+	ck_assert_int_eq(symbol_event_id(dev), 2);
+}
+END_TEST
+
+START_TEST(gesture_symbol_load_invalid)
+{
+	struct tptest_device *dev = tptest_current_device();
+	char path[] = "/tmp/tptest-symbols-XXXXXX";
+
+	symbol_write_file(dev, path, 1);
+	ck_assert_int_eq(touchpad_symbol_load_templates(dev->touchpad, path), -EINVAL);
+	unlink(path);
+	ck_assert_int_eq(touchpad_symbol_load_templates(dev->touchpad, path), -ENOENT);
+	symbol_enable(dev);
+
+	/* the first template was fine but isn't added either */
+	symbol_trace(dev, L_x, L_y, ARRAY_LENGTH(L_x));
+	ck_assert_int_eq(symbol_event_id(dev), -1);
+}
+END_TEST
+
+int main(int argc, char **argv) {
+	tptest_add("gesture_pinch", gesture_pinch_out, TOUCHPAD_ALL_MT_DEVICES);
+	tptest_add("gesture_pinch", gesture_pinch_in, TOUCHPAD_ALL_MT_DEVICES);
+	tptest_add("gesture_rotate", gesture_rotate, TOUCHPAD_ALL_MT_DEVICES);
+	tptest_add("gesture_config", gesture_disabled, TOUCHPAD_ALL_MT_DEVICES);
+	tptest_add("gesture_config", gesture_no_callbacks, TOUCHPAD_ALL_MT_DEVICES);
+	tptest_add("gesture_swipe", gesture_swipe_three_finger, TOUCHPAD_BCM5974);
+	tptest_add("gesture_swipe", gesture_swipe_four_finger, TOUCHPAD_BCM5974);
+	tptest_add("gesture_swipe", gesture_swipe_no_callbacks, TOUCHPAD_BCM5974);
+	tptest_add("gesture_swipe", gesture_swipe_v1_interface, TOUCHPAD_BCM5974);
+	tptest_add("gesture_swipe", gesture_swipe_fake_touches, TOUCHPAD_SYNAPTICS_CLICKPAD);
+	tptest_add("gesture_swipe", gesture_swipe_after_scroll, TOUCHPAD_BCM5974);
+	tptest_add("gesture_hold", gesture_hold, TOUCHPAD_ALL_DEVICES);
+	tptest_add("gesture_hold", gesture_hold_moved, TOUCHPAD_ALL_DEVICES);
+	tptest_add("gesture_hold", gesture_hold_no_callbacks, TOUCHPAD_ALL_DEVICES);
+	tptest_add("gesture_hold", gesture_hold_after_edge_scroll, TOUCHPAD_SYNAPTICS_CLICKPAD|TOUCHPAD_SYNAPTICS_NON_MT);
+	tptest_add("gesture_hold", gesture_hold_after_scroll, TOUCHPAD_ALL_MT_DEVICES);
+	tptest_add("gesture_symbol", gesture_symbol, TOUCHPAD_SYNAPTICS_CLICKPAD);
+	tptest_add("gesture_symbol", gesture_symbol_no_match, TOUCHPAD_SYNAPTICS_CLICKPAD);
+	tptest_add("gesture_symbol", gesture_symbol_disabled, TOUCHPAD_SYNAPTICS_CLICKPAD);
+	tptest_add("gesture_symbol", gesture_symbol_no_callback, TOUCHPAD_SYNAPTICS_CLICKPAD);
+	tptest_add("gesture_symbol", gesture_symbol_load, TOUCHPAD_SYNAPTICS_CLICKPAD);
+	tptest_add("gesture_symbol", gesture_symbol_load_invalid, TOUCHPAD_SYNAPTICS_CLICKPAD);
+
+	return tptest_run(argc, argv);
+}
@@ -0,0 +1,312 @@
+/*
+ * Copyright © 2013 Red Hat, Inc.
+ *
+ * Permission to use, copy, modify, distribute, and sell this software and its
+ * documentation for any purpose is hereby granted without fee, provided that
+ * the above copyright notice appear in all copies and that both that copyright
+ * notice and this permission notice appear in supporting documentation, and
+ * that the name of the copyright holders not be used in advertising or
+ * publicity pertaining to distribution of the software without specific,
+ * written prior permission.  The copyright holders make no representations
+ * about the suitability of this software for any purpose.  It is provided "as
+ * is" without express or implied warranty.
+ *
+ * THE COPYRIGHT HOLDERS DISCLAIM ALL WARRANTIES WITH REGARD TO THIS SOFTWARE,
+ * INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS, IN NO
+ * EVENT SHALL THE COPYRIGHT HOLDERS BE LIABLE FOR ANY SPECIAL, INDIRECT OR
+ * CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE,
+ * DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER
+ * TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE
+ * OF THIS SOFTWARE.
+ */
+
+#if HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <string.h>
+#include <unistd.h>
+
+#include "tptest.h"
+#include "touchpad-util.h"
+#include "touchpad-config.h"
+
+static void
+sum_motion(struct tptest_device *dev, int *dx, int *dy)
+{
+	union tptest_event *e;
+
+	*dx = 0;
+	*dy = 0;
+
+	ARRAY_FOR_EACH(dev->events, e) {
+		if (e->type == EVTYPE_NONE)
+			break;
+		if (e->type == EVTYPE_MOTION) {
+			*dx += tptest_motion_event(e)->x;
+			*dy += tptest_motion_event(e)->y;
+		}
+	}
+}
+
+static void
+clear_events(struct tptest_device *dev)
+{
+	memset(dev->events, 0, sizeof(dev->events));
+	dev->idx = 0;
+}
+
+/* no motion event may go right */
+static void
+assert_no_motion_right(struct tptest_device *dev)
+{
+	union tptest_event *e;
+
+	ARRAY_FOR_EACH(dev->events, e) {
+		if (e->type == EVTYPE_NONE)
+			break;
+		if (e->type == EVTYPE_MOTION)
+			ck_assert_int_le(tptest_motion_event(e)->x, 0);
+	}
+}
+
+START_TEST(motion_unfiltered)
+{
+	struct tptest_device *dev = tptest_current_device();
+	int dx, dy;
+
+	ck_assert_int_eq(touchpad_config_set(dev->touchpad, NULL,
+					     TOUCHPAD_CONFIG_MOTION_FILTERS, TOUCHPAD_MOTION_FILTER_NONE,
+					     TOUCHPAD_CONFIG_NONE), 0);
+
+	tptest_touch_down(dev, 0, 20, 20);
+	tptest_touch_move_to(dev, 0, 20, 20, 30, 20, 10);
+	tptest_touch_up(dev, 0);
+
+	while (tptest_handle_events(dev))
+		;
+
+	/* without filters, the deltas add up to the distance moved */
+	sum_motion(dev, &dx, &dy);
+	ck_assert_int_eq(dx, tptest_scale(dev, ABS_X, 30) - tptest_scale(dev, ABS_X, 20));
+	ck_assert_int_eq(dy, 0);
+}
+END_TEST
+
+START_TEST(motion_handoff_promote)
+{
+	struct tptest_device *dev = tptest_current_device();
+
+	/* two-finger scroll to the right, then the first finger lifts
+	   and the second one becomes the pointer */
+	tptest_touch_down(dev, 0, 30, 50);
+	tptest_touch_down(dev, 1, 50, 50);
+	tptest_touch_move_to(dev, 1, 50, 50, 70, 50, 10);
+	tptest_touch_up(dev, 0);
+	while (tptest_handle_events(dev))
+		;
+	clear_events(dev);
+
+	/* the new pointer's motion from before it took over must not
+	   leak into the pointer motion */
+	tptest_touch_move_to(dev, 1, 70, 50, 65, 50, 5);
+	tptest_touch_up(dev, 1);
+	while (tptest_handle_events(dev))
+		;
+
+	assert_no_motion_right(dev);
+}
+END_TEST
+
+START_TEST(motion_handoff_unpin)
+{
+	struct tptest_device *dev = tptest_current_device();
+
+	/* click and drag the pinned finger to the right */
+	tptest_touch_down(dev, 0, 50, 50);
+	tptest_click(dev, true);
+	tptest_touch_move_to(dev, 0, 50, 50, 60, 50, 5);
+	while (tptest_handle_events(dev))
+		;
+	clear_events(dev);
+
+	/* after the release, the finger moves the pointer again, without
+	   the motion it made while pinned */
+	tptest_click(dev, false);
+	tptest_touch_move_to(dev, 0, 60, 50, 55, 50, 5);
+	tptest_touch_up(dev, 0);
+	while (tptest_handle_events(dev))
+		;
+
+	assert_no_motion_right(dev);
+}
+END_TEST
+
+START_TEST(motion_semi_mt_finger_change)
+{
+	struct tptest_device *dev = tptest_current_device();
+
+	/* The touches move between the finger and the centre of the box
+	   when the second finger comes and goes. The finger itself only
+	   moves left, so must the pointer. */
+	tptest_touch_down(dev, 0, 30, 50);
+	tptest_touch_move_to(dev, 0, 30, 50, 25, 50, 5);
+	tptest_touch_down(dev, 1, 80, 50);
+	tptest_touch_up(dev, 1);
+	tptest_touch_move_to(dev, 0, 25, 50, 20, 50, 5);
+	tptest_touch_up(dev, 0);
+	while (tptest_handle_events(dev))
+		;
+
+	assert_no_motion_right(dev);
+}
+END_TEST
+
+START_TEST(motion_resting)
+{
+	struct tptest_device *dev = tptest_current_device();
+	int x = tptest_scale(dev, ABS_X, 20);
+	int dx, dy;
+
+	ck_assert_int_eq(touchpad_config_set(dev->touchpad, NULL,
+					     TOUCHPAD_CONFIG_MOTION_FILTERS, TOUCHPAD_MOTION_FILTER_NONE,
+					     TOUCHPAD_CONFIG_REST_FRAMES, 5,
+					     TOUCHPAD_CONFIG_NONE), 0);
+
+	/* a finger that only jitters by a unit comes to rest */
+	tptest_touch_down(dev, 0, 20, 50);
+	for (int i = 0; i < 5; i++) {
+		tptest_event(dev, EV_ABS, ABS_MT_POSITION_X, x + (i & 1));
+		tptest_event(dev, EV_SYN, SYN_REPORT, 0);
+	}
+	while (tptest_handle_events(dev))
+		;
+	clear_events(dev);
+
+	for (int i = 0; i < 10; i++) {
+		tptest_event(dev, EV_ABS, ABS_MT_POSITION_X, x + (i & 1));
+		tptest_event(dev, EV_SYN, SYN_REPORT, 0);
+	}
+	while (tptest_handle_events(dev))
+		;
+	sum_motion(dev, &dx, &dy);
+	ck_assert_int_eq(dev->idx, 0);
+
+	/* once it moves, it moves from where it came to rest */
+	tptest_touch_move_to(dev, 0, 20, 50, 30, 50, 5);
+	tptest_touch_up(dev, 0);
+	while (tptest_handle_events(dev))
+		;
+	sum_motion(dev, &dx, &dy);
+	ck_assert_int_ge(dx, tptest_scale(dev, ABS_X, 30) - x - 1);
+	ck_assert_int_le(dx, tptest_scale(dev, ABS_X, 30) - x);
+}
+END_TEST
+
+START_TEST(motion_jump)
+{
+	struct tptest_device *dev = tptest_current_device();
+	union tptest_event *e;
+	int step = tptest_scale(dev, ABS_X, 2) - tptest_scale(dev, ABS_X, 1);
+
+	/* a slow bound so the jump is implausible even if we sleep longer
+	   than asked for */
+	ck_assert_int_eq(touchpad_config_set(dev->touchpad, NULL,
+					     TOUCHPAD_CONFIG_MOTION_FILTERS, TOUCHPAD_MOTION_FILTER_JUMP,
+					     TOUCHPAD_CONFIG_JUMP_MAX_SPEED, 500,
+					     TOUCHPAD_CONFIG_NONE), 0);
+	ck_assert_int_eq(touchpad_get_jump_count(dev->touchpad), 0);
+
+	/* the timestamps are taken when the events are written, the
+	   filter needs them to be apart */
+	tptest_touch_down(dev, 0, 10, 50);
+	usleep(10000);
+	tptest_touch_move(dev, 0, 11, 50);
+	usleep(10000);
+	tptest_touch_move(dev, 0, 90, 50);
+	usleep(10000);
+	tptest_touch_move(dev, 0, 12, 50);
+	usleep(10000);
+	tptest_touch_move(dev, 0, 13, 50);
+	tptest_touch_up(dev, 0);
+
+	while (tptest_handle_events(dev))
+		;
+
+	ck_assert_int_eq(touchpad_get_jump_count(dev->touchpad), 1);
+
+	ARRAY_FOR_EACH(dev->events, e) {
+		if (e->type == EVTYPE_NONE)
+			break;
+		if (e->type == EVTYPE_MOTION)
+			ck_assert_int_le(abs(tptest_motion_event(e)->x), step + 1);
+	}
+}
+END_TEST
+
+START_TEST(motion_accel_flat)
+{
+	struct tptest_device *dev = tptest_current_device();
+	int dx, dy;
+	int distance;
+
+	ck_assert_int_eq(touchpad_config_set(dev->touchpad, NULL,
+					     TOUCHPAD_CONFIG_MOTION_FILTERS, TOUCHPAD_MOTION_FILTER_NONE,
+					     TOUCHPAD_CONFIG_ACCEL_PROFILE, TOUCHPAD_ACCEL_PROFILE_FLAT,
+					     TOUCHPAD_CONFIG_ACCEL_MIN_FACTOR, 30,
+					     TOUCHPAD_CONFIG_NONE), 0);
+
+	tptest_touch_down(dev, 0, 20, 20);
+	tptest_touch_move_to(dev, 0, 20, 20, 30, 20, 10);
+	tptest_touch_up(dev, 0);
+
+	while (tptest_handle_events(dev))
+		;
+
+	/* the remainder is carried over, so nothing gets lost to rounding */
+	sum_motion(dev, &dx, &dy);
+	distance = tptest_scale(dev, ABS_X, 30) - tptest_scale(dev, ABS_X, 20);
+	ck_assert_int_ge(dx, distance * 30/100 - 1);
+	ck_assert_int_le(dx, distance * 30/100 + 1);
+	ck_assert_int_eq(dy, 0);
+}
+END_TEST
+
+START_TEST(motion_accel_config)
+{
+	struct tptest_device *dev = tptest_current_device();
+	enum touchpad_config_error error;
+	int value;
+
+	ck_assert_int_eq(touchpad_config_get(dev->touchpad,
+					     TOUCHPAD_CONFIG_ACCEL_PROFILE, &value,
+					     TOUCHPAD_CONFIG_NONE), 0);
+	ck_assert_int_eq(value, TOUCHPAD_ACCEL_PROFILE_NONE);
+
+	ck_assert_int_eq(touchpad_config_set(dev->touchpad, &error,
+					     TOUCHPAD_CONFIG_ACCEL_PROFILE, TOUCHPAD_ACCEL_PROFILE_SMOOTH + 1,
+					     TOUCHPAD_CONFIG_NONE), 1);
+	ck_assert_int_eq(error, TOUCHPAD_CONFIG_ERROR_VALUE_INVALID);
+
+	ck_assert_int_eq(touchpad_config_set(dev->touchpad, &error,
+					     TOUCHPAD_CONFIG_ACCEL_MIN_FACTOR, 0,
+					     TOUCHPAD_CONFIG_NONE), 1);
+	ck_assert_int_eq(error, TOUCHPAD_CONFIG_ERROR_VALUE_TOO_LOW);
+}
+END_TEST
+
+int main(int argc, char **argv) {
+	tptest_add("motion", motion_unfiltered, TOUCHPAD_ALL_DEVICES|TOUCHPAD_SYNAPTICS_SEMI_MT);
+	tptest_add("motion_semi_mt", motion_semi_mt_finger_change, TOUCHPAD_SYNAPTICS_SEMI_MT);
+
+	tptest_add("motion_handoff", motion_handoff_promote, TOUCHPAD_ALL_MT_DEVICES);
+	tptest_add("motion_handoff", motion_handoff_unpin, TOUCHPAD_ALL_MT_DEVICES);
+
+	tptest_add("motion_resting", motion_resting, TOUCHPAD_SYNAPTICS_CLICKPAD|TOUCHPAD_BCM5974);
+
+	tptest_add("motion_jump", motion_jump, TOUCHPAD_ALL_DEVICES);
+
+	tptest_add("motion_accel", motion_accel_flat, TOUCHPAD_ALL_DEVICES);
+	tptest_add("motion_accel", motion_accel_config, TOUCHPAD_ALL_DEVICES);
+	return tptest_run(argc, argv);
+}
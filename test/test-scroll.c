@@ -24,6 +24,9 @@
 #include "config.h"
 #endif
 
+#include <string.h>
+#include <unistd.h>
+
 #include "tptest.h"
 #include "touchpad-util.h"
 #include "touchpad-config.h"
@@ -385,17 +388,511 @@ START_TEST(scroll_two_finger_horiz_lock)
 }
 END_TEST
 
+static void
+enable_edge_scrolling(struct tptest_device *dev)
+{
+	ck_assert_int_eq(touchpad_config_set(dev->touchpad, NULL,
+					     TOUCHPAD_CONFIG_SCROLL_METHOD,
+					     TOUCHPAD_SCROLL_EDGE_VERTICAL|TOUCHPAD_SCROLL_EDGE_HORIZONTAL,
+					     TOUCHPAD_CONFIG_NONE), 0);
+}
+
+START_TEST(scroll_edge_vert)
+{
+	struct tptest_device *dev = tptest_current_device();
+	union tptest_event *e;
+	union tptest_event *scroll = NULL;
+
+	enable_edge_scrolling(dev);
+
+	tptest_touch_down(dev, 0, 99, 20);
+	tptest_touch_move_to(dev, 0, 99, 20, 99, 80, -1);
+	tptest_touch_up(dev, 0);
+
+	while (tptest_handle_events(dev))
+		;
+
+	ARRAY_FOR_EACH(dev->events, e) {
+		if (e->type == EVTYPE_NONE)
+			break;
+		ck_assert_int_ne(e->type, EVTYPE_MOTION);
+		if (e->type == EVTYPE_SCROLL) {
+			ck_assert_int_ge(tptest_scroll_event(e)->units, 0);
+			ck_assert_int_eq(tptest_scroll_event(e)->dir, TOUCHPAD_SCROLL_VERTICAL);
+			scroll = e;
+		}
+	}
+
+	ck_assert(scroll != NULL);
+	ck_assert(scroll->scroll.units == 0.0);
+}
+END_TEST
+
+START_TEST(scroll_edge_horiz)
+{
+	struct tptest_device *dev = tptest_current_device();
+	union tptest_event *e;
+	union tptest_event *scroll = NULL;
+
+	enable_edge_scrolling(dev);
+
+	tptest_touch_down(dev, 0, 80, 99);
+	tptest_touch_move_to(dev, 0, 80, 99, 20, 99, -1);
+	tptest_touch_up(dev, 0);
+
+	while (tptest_handle_events(dev))
+		;
+
+	ARRAY_FOR_EACH(dev->events, e) {
+		if (e->type == EVTYPE_NONE)
+			break;
+		ck_assert_int_ne(e->type, EVTYPE_MOTION);
+		if (e->type == EVTYPE_SCROLL) {
+			ck_assert_int_le(tptest_scroll_event(e)->units, 0);
+			ck_assert_int_eq(tptest_scroll_event(e)->dir, TOUCHPAD_SCROLL_HORIZONTAL);
+			scroll = e;
+		}
+	}
+
+	ck_assert(scroll != NULL);
+	ck_assert(scroll->scroll.units == 0.0);
+}
+END_TEST
+
+START_TEST(scroll_edge_softbuttons)
+{
+	struct tptest_device *dev = tptest_current_device();
+	union tptest_event *e;
+	bool clicked = false;
+
+	enable_edge_scrolling(dev);
+
+	/* the bottom edge lies in the software button area, a finger
+	   there clicks but doesn't scroll */
+	tptest_touch_down(dev, 0, 80, 99);
+	tptest_touch_move_to(dev, 0, 80, 99, 50, 99, -1);
+	tptest_click(dev, true);
+	tptest_click(dev, false);
+	tptest_touch_move_to(dev, 0, 50, 99, 20, 99, -1);
+	tptest_touch_up(dev, 0);
+
+	while (tptest_handle_events(dev))
+		;
+
+	ARRAY_FOR_EACH(dev->events, e) {
+		if (e->type == EVTYPE_NONE)
+			break;
+		ck_assert_int_ne(e->type, EVTYPE_SCROLL);
+		if (e->type == EVTYPE_BUTTON && tptest_button_event(e)->is_press)
+			clicked = true;
+	}
+
+	ck_assert(clicked);
+}
+END_TEST
+
+START_TEST(scroll_edge_leave)
+{
+	struct tptest_device *dev = tptest_current_device();
+	union tptest_event *e;
+	bool motion = false;
+
+	enable_edge_scrolling(dev);
+
+	/* a finger that leaves the edge before scrolling moves the pointer */
+	tptest_touch_down(dev, 0, 99, 50);
+	tptest_touch_move_to(dev, 0, 99, 50, 50, 50, -1);
+	tptest_touch_up(dev, 0);
+
+	while (tptest_handle_events(dev))
+		;
+
+	ARRAY_FOR_EACH(dev->events, e) {
+		if (e->type == EVTYPE_NONE)
+			break;
+		ck_assert_int_ne(e->type, EVTYPE_SCROLL);
+		if (e->type == EVTYPE_MOTION)
+			motion = true;
+	}
+
+	ck_assert(motion);
+}
+END_TEST
+
+/* two fingers flick down. The speed comes from the event timestamps,
+   so the moves are spread out in time. Callers lift the fingers
+   straight after, within the window the release speed is taken from. */
+static void
+flick_down(struct tptest_device *dev)
+{
+	for (int i = 1; i <= 6; i++) {
+		usleep(10000);
+		tptest_touch_move(dev, 0, 20, 20 + i * 5);
+		tptest_touch_move(dev, 1, 30, 20 + i * 5);
+		while (tptest_handle_events(dev))
+			;
+	}
+}
+
+/* both fingers lift off in the same frame */
+static void
+lift_both(struct tptest_device *dev)
+{
+	tptest_event(dev, EV_ABS, ABS_MT_SLOT, 0);
+	tptest_event(dev, EV_ABS, ABS_MT_TRACKING_ID, -1);
+	tptest_event(dev, EV_ABS, ABS_MT_SLOT, 1);
+	tptest_event(dev, EV_ABS, ABS_MT_TRACKING_ID, -1);
+	tptest_event(dev, EV_SYN, SYN_REPORT, 0);
+	while (tptest_handle_events(dev))
+		;
+}
+
+/**
+ * @return the number of scroll events, with *stopped set if one of them
+ * terminated the scroll
+ */
+static int
+count_scroll_events(struct tptest_device *dev, bool *stopped)
+{
+	union tptest_event *e;
+	int count = 0;
+
+	ARRAY_FOR_EACH(dev->events, e) {
+		if (e->type == EVTYPE_NONE)
+			break;
+		if (e->type == EVTYPE_SCROLL) {
+			ck_assert_int_ge(tptest_scroll_event(e)->units, 0);
+			ck_assert_int_eq(tptest_scroll_event(e)->dir, TOUCHPAD_SCROLL_VERTICAL);
+			if (tptest_scroll_event(e)->units == 0.0)
+				*stopped = true;
+			count++;
+		}
+	}
+
+	memset(dev->events, 0, sizeof(dev->events));
+	dev->idx = 0;
+
+	return count;
+}
+
+START_TEST(scroll_kinetic)
+{
+	struct tptest_device *dev = tptest_current_device();
+	bool stopped = false;
+	int count = 0;
+
+	ck_assert_int_eq(touchpad_config_set(dev->touchpad, NULL,
+					     TOUCHPAD_CONFIG_SCROLL_KINETIC, 1,
+					     TOUCHPAD_CONFIG_NONE), 0);
+
+	tptest_touch_down(dev, 0, 20, 20);
+	tptest_touch_down(dev, 1, 30, 20);
+	flick_down(dev);
+	lift_both(dev);
+	count_scroll_events(dev, &stopped);
+	ck_assert(!stopped);
+
+	/* scrolling carries on from the timer until it runs out */
+	while (!stopped && tptest_wait_for_events(dev, 1000))
+		count += count_scroll_events(dev, &stopped);
+
+	ck_assert(stopped);
+	ck_assert_int_gt(count, 1);
+}
+END_TEST
+
+START_TEST(scroll_kinetic_interrupted)
+{
+	struct tptest_device *dev = tptest_current_device();
+	bool stopped = false;
+
+	ck_assert_int_eq(touchpad_config_set(dev->touchpad, NULL,
+					     TOUCHPAD_CONFIG_SCROLL_KINETIC, 1,
+					     TOUCHPAD_CONFIG_NONE), 0);
+
+	tptest_touch_down(dev, 0, 20, 20);
+	tptest_touch_down(dev, 1, 30, 20);
+	flick_down(dev);
+	lift_both(dev);
+	count_scroll_events(dev, &stopped);
+	ck_assert(!stopped);
+
+	/* a new finger stops it right away */
+	tptest_touch_down(dev, 0, 50, 50);
+	while (tptest_handle_events(dev))
+		;
+	ck_assert_int_eq(count_scroll_events(dev, &stopped), 1);
+	ck_assert(stopped);
+
+	/* and no kinetic timer fires after that */
+	while (tptest_wait_for_events(dev, 50))
+		;
+	ck_assert_int_eq(count_scroll_events(dev, &stopped), 0);
+
+	tptest_touch_up(dev, 0);
+}
+END_TEST
+
+START_TEST(scroll_kinetic_one_finger_stays)
+{
+	struct tptest_device *dev = tptest_current_device();
+	union tptest_event *e;
+	bool stopped = false;
+	bool moved = false;
+
+	ck_assert_int_eq(touchpad_config_set(dev->touchpad, NULL,
+					     TOUCHPAD_CONFIG_SCROLL_KINETIC, 1,
+					     TOUCHPAD_CONFIG_NONE), 0);
+
+	tptest_touch_down(dev, 0, 20, 20);
+	tptest_touch_down(dev, 1, 30, 20);
+	flick_down(dev);
+	count_scroll_events(dev, &stopped);
+	ck_assert(!stopped);
+
+	/* one finger lifts, the scroll ends and the other one moves the
+	   pointer */
+	tptest_touch_up(dev, 1);
+	tptest_touch_move_to(dev, 0, 20, 50, 60, 50, 10);
+	while (tptest_handle_events(dev))
+		;
+
+	ARRAY_FOR_EACH(dev->events, e) {
+		if (e->type == EVTYPE_NONE)
+			break;
+		if (e->type == EVTYPE_MOTION && tptest_motion_event(e)->x > 0)
+			moved = true;
+	}
+	ck_assert(moved);
+	ck_assert_int_eq(count_scroll_events(dev, &stopped), 1);
+	ck_assert(stopped);
+
+	tptest_touch_up(dev, 0);
+}
+END_TEST
+
+START_TEST(scroll_two_axis_diagonal)
+{
+	struct tptest_device *dev;
+	union tptest_event *e;
+	union tptest_event *last = NULL, *prev = NULL;
+	bool vert = false, horiz = false;
+
+	dev = tptest_current_device();
+
+	touchpad_config_set(dev->touchpad, NULL,
+			    TOUCHPAD_CONFIG_SCROLL_METHOD,
+			    TOUCHPAD_SCROLL_TWOFINGER_VERTICAL|TOUCHPAD_SCROLL_TWOFINGER_HORIZONTAL,
+			    TOUCHPAD_CONFIG_SCROLL_TWO_AXIS, 1,
+			    TOUCHPAD_CONFIG_SCROLL_AXIS_LOCK, 0,
+			    TOUCHPAD_CONFIG_NONE);
+
+	tptest_touch_down(dev, 0, 20, 20);
+	tptest_touch_down(dev, 1, 30, 20);
+	tptest_touch_move_to(dev, 0, 20, 20, 60, 60, -1);
+	tptest_touch_move_to(dev, 1, 30, 20, 70, 60, -1);
+	tptest_touch_up(dev, 0);
+	tptest_touch_up(dev, 1);
+
+	while (tptest_handle_events(dev))
+		;
+
+	ARRAY_FOR_EACH(dev->events, e) {
+		if (e->type == EVTYPE_NONE)
+			break;
+		if (e->type != EVTYPE_SCROLL)
+			continue;
+
+		ck_assert_int_ge(tptest_scroll_event(e)->units, 0);
+		if (tptest_scroll_event(e)->units > 0) {
+			if (tptest_scroll_event(e)->dir == TOUCHPAD_SCROLL_VERTICAL)
+				vert = true;
+			else
+				horiz = true;
+		}
+		prev = last;
+		last = e;
+	}
+
+	ck_assert(vert);
+	ck_assert(horiz);
+
+	/* both axes are terminated */
+	ck_assert(prev != NULL);
+	ck_assert(prev->scroll.units == 0.0);
+	ck_assert(last->scroll.units == 0.0);
+	ck_assert_int_ne(prev->scroll.dir, last->scroll.dir);
+}
+END_TEST
+
+START_TEST(scroll_two_axis_lock)
+{
+	struct tptest_device *dev;
+	union tptest_event *e;
+	bool vert = false;
+
+	dev = tptest_current_device();
+
+	touchpad_config_set(dev->touchpad, NULL,
+			    TOUCHPAD_CONFIG_SCROLL_METHOD,
+			    TOUCHPAD_SCROLL_TWOFINGER_VERTICAL|TOUCHPAD_SCROLL_TWOFINGER_HORIZONTAL,
+			    TOUCHPAD_CONFIG_SCROLL_TWO_AXIS, 1,
+			    TOUCHPAD_CONFIG_NONE);
+
+	/* nearly vertical, within the default axis lock */
+	tptest_touch_down(dev, 0, 20, 20);
+	tptest_touch_down(dev, 1, 30, 20);
+	tptest_touch_move_to(dev, 0, 20, 20, 22, 80, -1);
+	tptest_touch_move_to(dev, 1, 30, 20, 32, 80, -1);
+	tptest_touch_up(dev, 0);
+	tptest_touch_up(dev, 1);
+
+	while (tptest_handle_events(dev))
+		;
+
+	ARRAY_FOR_EACH(dev->events, e) {
+		if (e->type == EVTYPE_NONE)
+			break;
+		if (e->type != EVTYPE_SCROLL)
+			continue;
+
+		if (tptest_scroll_event(e)->dir == TOUCHPAD_SCROLL_HORIZONTAL)
+			ck_assert(tptest_scroll_event(e)->units == 0.0);
+		else if (tptest_scroll_event(e)->units > 0)
+			vert = true;
+	}
+
+	ck_assert(vert);
+}
+END_TEST
+
+START_TEST(scroll_hires)
+{
+	struct tptest_device *dev;
+	union tptest_event *e;
+	union tptest_event *scroll = NULL;
+	int total = 0;
+
+	dev = tptest_current_device();
+	tptest_use_hires_scroll(dev);
+
+	tptest_touch_down(dev, 0, 20, 20);
+	tptest_touch_down(dev, 1, 30, 20);
+	tptest_touch_move_to(dev, 0, 20, 20, 20, 80, -1);
+	tptest_touch_move_to(dev, 1, 30, 20, 30, 80, -1);
+	tptest_touch_up(dev, 0);
+	tptest_touch_up(dev, 1);
+
+	while (tptest_handle_events(dev))
+		;
+
+	ARRAY_FOR_EACH(dev->events, e) {
+		if (e->type == EVTYPE_NONE)
+			break;
+		if (e->type != EVTYPE_SCROLL)
+			continue;
+
+		ck_assert_int_eq(tptest_scroll_event(e)->dir, TOUCHPAD_SCROLL_VERTICAL);
+		if (scroll == NULL)
+			ck_assert_int_ge(tptest_scroll_event(e)->hires, TOUCHPAD_SCROLL_HIRES_UNITS);
+		else
+			ck_assert_int_ge(tptest_scroll_event(e)->hires, 0);
+		total += tptest_scroll_event(e)->hires;
+		scroll = e;
+	}
+
+	ck_assert(scroll != NULL);
+	ck_assert_int_eq(scroll->scroll.hires, 0);
+	ck_assert_int_gt(total, TOUCHPAD_SCROLL_HIRES_UNITS);
+}
+END_TEST
+
+/* Two fingers down across most of the touchpad in the given number of
+ * steps, ms apart. Returns the total units scrolled */
+static double
+scroll_down(struct tptest_device *dev, int steps, int ms)
+{
+	union tptest_event *e;
+	double total = 0;
+
+	tptest_touch_down(dev, 0, 20, 10);
+	tptest_touch_down(dev, 1, 30, 10);
+	for (int i = 1; i <= steps; i++) {
+		tptest_touch_move(dev, 0, 20, 10 + 60 * i/steps);
+		tptest_touch_move(dev, 1, 30, 10 + 60 * i/steps);
+		usleep(ms * 1000);
+	}
+	tptest_touch_up(dev, 0);
+	tptest_touch_up(dev, 1);
+
+	while (tptest_handle_events(dev))
+		;
+
+	ARRAY_FOR_EACH(dev->events, e) {
+		if (e->type == EVTYPE_NONE)
+			break;
+		if (e->type == EVTYPE_SCROLL)
+			total += tptest_scroll_event(e)->units;
+	}
+
+	memset(dev->events, 0, sizeof(dev->events));
+	dev->idx = 0;
+
+	return total;
+}
+
+START_TEST(scroll_accel)
+{
+	struct tptest_device *dev;
+	double slow, fast;
+	double slow_accel, fast_accel;
+
+	dev = tptest_current_device();
+
+	slow = scroll_down(dev, 40, 30);
+	fast = scroll_down(dev, 4, 10);
+
+	touchpad_config_set(dev->touchpad, NULL,
+			    TOUCHPAD_CONFIG_SCROLL_ACCEL_PROFILE,
+			    TOUCHPAD_ACCEL_PROFILE_LINEAR,
+			    TOUCHPAD_CONFIG_NONE);
+
+	slow_accel = scroll_down(dev, 40, 30);
+	fast_accel = scroll_down(dev, 4, 10);
+
+	/* the same distance scrolls further when fast, slow is as-is */
+	ck_assert(fast_accel > fast * 1.5);
+	ck_assert(slow_accel < slow * 1.1);
+}
+END_TEST
+
 int main(int argc, char **argv) {
-	tptest_add("scroll_two_finger_vert", scroll_two_finger_vert_down, TOUCHPAD_ALL_MT_DEVICES);
-	tptest_add("scroll_two_finger_vert", scroll_two_finger_vert_up, TOUCHPAD_ALL_MT_DEVICES);
+	tptest_add("scroll_two_finger_vert", scroll_two_finger_vert_down, TOUCHPAD_ALL_MT_DEVICES|TOUCHPAD_SYNAPTICS_SEMI_MT);
+	tptest_add("scroll_two_finger_vert", scroll_two_finger_vert_up, TOUCHPAD_ALL_MT_DEVICES|TOUCHPAD_SYNAPTICS_SEMI_MT);
 	tptest_add("scroll_two_finger_vert", scroll_two_finger_single_finger_vert_down, TOUCHPAD_ALL_MT_DEVICES);
 	tptest_add("scroll_two_finger_vert", scroll_two_finger_single_finger_vert_up, TOUCHPAD_ALL_MT_DEVICES);
 	tptest_add("scroll_two_finger_vert", scroll_two_finger_vert_lock, TOUCHPAD_ALL_MT_DEVICES);
 
-	tptest_add("scroll_two_finger_horiz", scroll_two_finger_horiz_left, TOUCHPAD_ALL_MT_DEVICES);
-	tptest_add("scroll_two_finger_horiz", scroll_two_finger_horiz_right, TOUCHPAD_ALL_MT_DEVICES);
+	tptest_add("scroll_two_finger_horiz", scroll_two_finger_horiz_left, TOUCHPAD_ALL_MT_DEVICES|TOUCHPAD_SYNAPTICS_SEMI_MT);
+	tptest_add("scroll_two_finger_horiz", scroll_two_finger_horiz_right, TOUCHPAD_ALL_MT_DEVICES|TOUCHPAD_SYNAPTICS_SEMI_MT);
 	tptest_add("scroll_two_finger_horiz", scroll_two_finger_single_finger_horiz_left, TOUCHPAD_ALL_MT_DEVICES);
 	tptest_add("scroll_two_finger_horiz", scroll_two_finger_single_finger_horiz_right, TOUCHPAD_ALL_MT_DEVICES);
 	tptest_add("scroll_two_finger_vert", scroll_two_finger_horiz_lock, TOUCHPAD_ALL_MT_DEVICES);
+
+	tptest_add("scroll_edge", scroll_edge_vert, TOUCHPAD_SYNAPTICS_CLICKPAD|TOUCHPAD_SYNAPTICS_NON_MT);
+	tptest_add("scroll_edge", scroll_edge_horiz, TOUCHPAD_SYNAPTICS_NON_MT);
+	tptest_add("scroll_edge", scroll_edge_softbuttons, TOUCHPAD_SYNAPTICS_CLICKPAD);
+	tptest_add("scroll_edge", scroll_edge_leave, TOUCHPAD_SYNAPTICS_CLICKPAD|TOUCHPAD_SYNAPTICS_NON_MT);
+
+	tptest_add("scroll_kinetic", scroll_kinetic, TOUCHPAD_ALL_MT_DEVICES);
+	tptest_add("scroll_kinetic", scroll_kinetic_interrupted, TOUCHPAD_ALL_MT_DEVICES);
+	tptest_add("scroll_kinetic", scroll_kinetic_one_finger_stays, TOUCHPAD_ALL_MT_DEVICES);
+
+	tptest_add("scroll_two_axis", scroll_two_axis_diagonal, TOUCHPAD_ALL_MT_DEVICES);
+	tptest_add("scroll_two_axis", scroll_two_axis_lock, TOUCHPAD_ALL_MT_DEVICES);
+
+	tptest_add("scroll_hires", scroll_hires, TOUCHPAD_ALL_MT_DEVICES);
+
+	tptest_add("scroll_accel", scroll_accel, TOUCHPAD_ALL_MT_DEVICES);
 	return tptest_run(argc, argv);
 }
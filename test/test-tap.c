@@ -62,6 +62,51 @@ START_TEST(tap_single_finger)
 }
 END_TEST
 
+START_TEST(tap_single_finger_rest)
+{
+	struct tptest_device *dev;
+	union tptest_event *e;
+	bool tap_down = false, tap_up = false;
+	int tap_timeout, rest_frames;
+	int x;
+
+	dev = tptest_current_device();
+	x = tptest_scale(dev, ABS_X, 30);
+	touchpad_config_get(dev->touchpad,
+			    TOUCHPAD_CONFIG_TAP_TIMEOUT, &tap_timeout,
+			    TOUCHPAD_CONFIG_REST_FRAMES, &rest_frames,
+			    TOUCHPAD_CONFIG_NONE);
+	ck_assert_int_gt(rest_frames, 0);
+
+	/* the finger only jitters by a unit and comes to rest before it
+	   lifts, the release still ends the tap */
+	tptest_touch_down(dev, 0, 30, 30);
+	for (int i = 0; i < rest_frames + 5; i++) {
+		tptest_event(dev, EV_ABS, ABS_MT_POSITION_X, x + (i & 1));
+		tptest_event(dev, EV_SYN, SYN_REPORT, 0);
+	}
+	tptest_touch_up(dev, 0);
+
+	usleep(tap_timeout * 2 * 1000);
+	tptest_handle_events(dev);
+
+	ARRAY_FOR_EACH(dev->events, e) {
+		if (e->type == EVTYPE_NONE)
+			break;
+		if (e->type == EVTYPE_TAP) {
+			if (tptest_tap_event(e)->is_press)
+				tap_down = true;
+			else
+				tap_up = true;
+			ck_assert_int_eq(tptest_tap_event(e)->fingers, 1);
+		}
+	}
+
+	ck_assert(tap_down);
+	ck_assert(tap_up);
+}
+END_TEST
+
 START_TEST(tap_single_finger_move)
 {
 	struct tptest_device *dev;
@@ -542,6 +587,7 @@ END_TEST
 
 int main(int argc, char **argv) {
 	tptest_add("tap_single_finger", tap_single_finger, TOUCHPAD_ALL_DEVICES);
+	tptest_add("tap_single_finger", tap_single_finger_rest, TOUCHPAD_SYNAPTICS_CLICKPAD|TOUCHPAD_BCM5974);
 	tptest_add("tap_single_finger", tap_single_finger_move, TOUCHPAD_ALL_DEVICES);
 	tptest_add("tap_single_finger", tap_single_finger_hold, TOUCHPAD_ALL_DEVICES);
 	tptest_add("tap_single_finger", tap_single_finger_doubletap, TOUCHPAD_ALL_DEVICES);
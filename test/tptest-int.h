@@ -37,6 +37,8 @@ struct device {
 	void (*create)(struct tptest_device *d);
 	void (*touch_down)(struct tptest_device *d, unsigned int slot, int x, int y);
 	void (*move)(struct tptest_device *d, unsigned int slot, int x, int y);
+	/* optional, the default ends the slot's tracking ID */
+	void (*touch_up)(struct tptest_device *d, unsigned int slot);
 
 	int min[2];
 	int max[2];
@@ -45,6 +47,5 @@ struct device {
 };
 
 void tptest_set_current_device(struct tptest_device *device);
-int tptest_scale(const struct tptest_device *d, unsigned int axis, int val);
 
 #endif
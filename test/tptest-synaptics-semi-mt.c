@@ -0,0 +1,175 @@
+/*
+ * Copyright © 2013 Red Hat, Inc.
+ *
+ * Permission to use, copy, modify, distribute, and sell this software and its
+ * documentation for any purpose is hereby granted without fee, provided that
+ * the above copyright notice appear in all copies and that both that copyright
+ * notice and this permission notice appear in supporting documentation, and
+ * that the name of the copyright holders not be used in advertising or
+ * publicity pertaining to distribution of the software without specific,
+ * written prior permission.  The copyright holders make no representations
+ * about the suitability of this software for any purpose.  It is provided "as
+ * is" without express or implied warranty.
+ *
+ * THE COPYRIGHT HOLDERS DISCLAIM ALL WARRANTIES WITH REGARD TO THIS SOFTWARE,
+ * INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS, IN NO
+ * EVENT SHALL THE COPYRIGHT HOLDERS BE LIABLE FOR ANY SPECIAL, INDIRECT OR
+ * CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE,
+ * DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER
+ * TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE
+ * OF THIS SOFTWARE.
+ */
+
+
+#if HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <string.h>
+
+#include "tptest.h"
+#include "tptest-int.h"
+#include "touchpad-util.h"
+
+/* A semi-MT touchpad reports the bounding box of the fingers, not the
+ * fingers. We keep track of where the fingers really are and send the
+ * box on each change. */
+static struct finger {
+	bool down;
+	int x, y; /* in device units */
+} fingers[2];
+
+void
+tptest_create_synaptics_semi_mt(struct tptest_device *d)
+{
+	struct libevdev *dev;
+	struct input_absinfo abs[] = {
+		{ ABS_X, 1472, 5472, 75 },
+		{ ABS_Y, 1408, 4448, 129 },
+		{ ABS_PRESSURE, 0, 255, 0 },
+		{ ABS_TOOL_WIDTH, 0, 15, 0 },
+		{ ABS_MT_SLOT, 0, 1, 0 },
+		{ ABS_MT_POSITION_X, 1472, 5472, 75 },
+		{ ABS_MT_POSITION_Y, 1408, 4448, 129 },
+		{ ABS_MT_TRACKING_ID, 0, 65535, 0 },
+	};
+	struct input_absinfo *a;
+	int rc;
+
+	memset(fingers, 0, sizeof(fingers));
+
+	dev = libevdev_new();
+	ck_assert(dev != NULL);
+
+	libevdev_set_name(dev, "SynPS/2 Synaptics TouchPad");
+	libevdev_set_id_bustype(dev, 0x11);
+	libevdev_set_id_vendor(dev, 0x2);
+	libevdev_set_id_product(dev, 0x7);
+	libevdev_enable_property(dev, INPUT_PROP_SEMI_MT);
+	libevdev_enable_event_code(dev, EV_KEY, BTN_LEFT, NULL);
+	libevdev_enable_event_code(dev, EV_KEY, BTN_TOOL_FINGER, NULL);
+	libevdev_enable_event_code(dev, EV_KEY, BTN_TOUCH, NULL);
+	libevdev_enable_event_code(dev, EV_KEY, BTN_TOOL_DOUBLETAP, NULL);
+	libevdev_enable_event_code(dev, EV_KEY, BTN_TOOL_TRIPLETAP, NULL);
+
+	ARRAY_FOR_EACH(abs, a)
+		libevdev_enable_event_code(dev, EV_ABS, a->value, a);
+
+	rc = libevdev_uinput_create_from_device(dev,
+						LIBEVDEV_UINPUT_OPEN_MANAGED,
+						&d->uinput);
+	ck_assert_int_eq(rc, 0);
+	libevdev_free(dev);
+}
+
+void tptest_synaptics_semi_mt_setup(void)
+{
+	struct tptest_device *d = tptest_create_device(TOUCHPAD_SYNAPTICS_SEMI_MT);
+	tptest_set_current_device(d);
+}
+
+/* Send the box for the fingers currently down, without the SYN_REPORT.
+ * With both fingers down, slot 0 has the top-left and slot 1 the
+ * bottom-right corner. A single finger is sent as is, in its slot. */
+static void
+semi_mt_send_box(struct tptest_device *d)
+{
+	bool both = fingers[0].down && fingers[1].down;
+	struct finger *first = fingers[0].down ? &fingers[0] : &fingers[1];
+
+	for (int slot = 0; slot < 2; slot++) {
+		int x = fingers[slot].x,
+		    y = fingers[slot].y;
+
+		if (!fingers[slot].down)
+			continue;
+
+		if (both) {
+			x = slot ? max(fingers[0].x, fingers[1].x) : min(fingers[0].x, fingers[1].x);
+			y = slot ? max(fingers[0].y, fingers[1].y) : min(fingers[0].y, fingers[1].y);
+		}
+
+		tptest_event(d, EV_ABS, ABS_MT_SLOT, slot);
+		tptest_event(d, EV_ABS, ABS_MT_POSITION_X, x);
+		tptest_event(d, EV_ABS, ABS_MT_POSITION_Y, y);
+	}
+
+	if (first->down) {
+		tptest_event(d, EV_ABS, ABS_X, first->x);
+		tptest_event(d, EV_ABS, ABS_Y, first->y);
+	}
+
+	tptest_event(d, EV_KEY, BTN_TOOL_FINGER, !both);
+	tptest_event(d, EV_KEY, BTN_TOOL_DOUBLETAP, both);
+}
+
+void
+tptest_synaptics_semi_mt_touch_down(struct tptest_device *d, unsigned int slot, int x, int y)
+{
+	static int tracking_id;
+
+	ck_assert_int_lt(slot, ARRAY_LENGTH(fingers));
+
+	fingers[slot].down = true;
+	fingers[slot].x = tptest_scale(d, ABS_X, x);
+	fingers[slot].y = tptest_scale(d, ABS_Y, y);
+
+	tptest_event(d, EV_ABS, ABS_MT_SLOT, slot);
+	tptest_event(d, EV_ABS, ABS_MT_TRACKING_ID, ++tracking_id);
+	semi_mt_send_box(d);
+	tptest_event(d, EV_ABS, ABS_PRESSURE, 30);
+	tptest_event(d, EV_KEY, BTN_TOUCH, 1);
+	tptest_event(d, EV_SYN, SYN_REPORT, 0);
+}
+
+void
+tptest_synaptics_semi_mt_move(struct tptest_device *d, unsigned int slot, int x, int y)
+{
+	ck_assert_int_lt(slot, ARRAY_LENGTH(fingers));
+
+	fingers[slot].x = tptest_scale(d, ABS_X, x);
+	fingers[slot].y = tptest_scale(d, ABS_Y, y);
+
+	semi_mt_send_box(d);
+	tptest_event(d, EV_SYN, SYN_REPORT, 0);
+}
+
+void
+tptest_synaptics_semi_mt_touch_up(struct tptest_device *d, unsigned int slot)
+{
+	ck_assert_int_lt(slot, ARRAY_LENGTH(fingers));
+
+	fingers[slot].down = false;
+
+	tptest_event(d, EV_ABS, ABS_MT_SLOT, slot);
+	tptest_event(d, EV_ABS, ABS_MT_TRACKING_ID, -1);
+
+	if (fingers[0].down || fingers[1].down) {
+		semi_mt_send_box(d);
+	} else {
+		tptest_event(d, EV_KEY, BTN_TOOL_FINGER, 0);
+		tptest_event(d, EV_KEY, BTN_TOOL_DOUBLETAP, 0);
+		tptest_event(d, EV_KEY, BTN_TOUCH, 0);
+	}
+	tptest_event(d, EV_SYN, SYN_REPORT, 0);
+}
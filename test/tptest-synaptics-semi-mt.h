@@ -0,0 +1,40 @@
+/*
+ * Copyright © 2013 Red Hat, Inc.
+ *
+ * Permission to use, copy, modify, distribute, and sell this software and its
+ * documentation for any purpose is hereby granted without fee, provided that
+ * the above copyright notice appear in all copies and that both that copyright
+ * notice and this permission notice appear in supporting documentation, and
+ * that the name of the copyright holders not be used in advertising or
+ * publicity pertaining to distribution of the software without specific,
+ * written prior permission.  The copyright holders make no representations
+ * about the suitability of this software for any purpose.  It is provided "as
+ * is" without express or implied warranty.
+ *
+ * THE COPYRIGHT HOLDERS DISCLAIM ALL WARRANTIES WITH REGARD TO THIS SOFTWARE,
+ * INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS, IN NO
+ * EVENT SHALL THE COPYRIGHT HOLDERS BE LIABLE FOR ANY SPECIAL, INDIRECT OR
+ * CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE,
+ * DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER
+ * TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE
+ * OF THIS SOFTWARE.
+ */
+
+
+#if HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#ifndef TPTEST_SYNAPTICS_SEMI_MT_H
+#define TPTEST_SYNAPTICS_SEMI_MT_H
+
+#include "tptest.h"
+#include "tptest-int.h"
+
+void tptest_create_synaptics_semi_mt(struct tptest_device *d);
+void tptest_synaptics_semi_mt_setup(void);
+void tptest_synaptics_semi_mt_touch_down(struct tptest_device *d, unsigned int slot, int x, int y);
+void tptest_synaptics_semi_mt_move(struct tptest_device *d, unsigned int slot, int x, int y);
+void tptest_synaptics_semi_mt_touch_up(struct tptest_device *d, unsigned int slot);
+
+#endif
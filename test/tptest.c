@@ -28,6 +28,7 @@
 #include "tptest-int.h"
 #include "tptest-synaptics.h"
 #include "tptest-synaptics-non-mt.h"
+#include "tptest-synaptics-semi-mt.h"
 #include "tptest-bcm5974.h"
 #include "touchpad.h"
 #include "touchpad-config.h"
@@ -40,6 +41,7 @@
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <time.h>
 #include <unistd.h>
 #include <ccan/list/list.h>
@@ -100,6 +102,16 @@ struct device devices[] = {
 		.touch_down = tptest_synaptics_non_mt_touch_down,
 		.move = tptest_synaptics_non_mt_move,
 	},
+	{
+		.type = TOUCHPAD_SYNAPTICS_SEMI_MT,
+		.shortname = "synaptics-semi-mt",
+		.setup = tptest_synaptics_semi_mt_setup,
+		.teardown = generic_device_teardown,
+		.create = tptest_create_synaptics_semi_mt,
+		.touch_down = tptest_synaptics_semi_mt_touch_down,
+		.move = tptest_synaptics_semi_mt_move,
+		.touch_up = tptest_synaptics_semi_mt_touch_up,
+	},
 	{
 		.type = TOUCHPAD_BCM5974,
 		.shortname = "bcm5974",
@@ -334,16 +346,88 @@ scroll(struct touchpad *t, void *userdata, enum touchpad_scroll_direction dir, d
 	push_event(d, &e);
 }
 
+static void
+scroll_hires(struct touchpad *t, void *userdata, enum touchpad_scroll_direction dir, int value)
+{
+	struct tptest_device *d = userdata;
+	union tptest_event e = { .scroll.type = EVTYPE_SCROLL,
+				  .scroll.dir = dir,
+				  .scroll.units = (double)value/TOUCHPAD_SCROLL_HIRES_UNITS,
+				  .scroll.hires = value };
+	push_event(d, &e);
+}
+
 static void
 rotate(struct touchpad *tp, void *userdata, int degrees)
 {
-	argcheck_not_reached();
+	struct tptest_device *d = userdata;
+	union tptest_event e = { .rotate.type = EVTYPE_ROTATE,
+				 .rotate.degrees = degrees };
+	push_event(d, &e);
 }
 
 static void
 pinch(struct touchpad *tp, void *userdata, int scale)
 {
-	argcheck_not_reached();
+	struct tptest_device *d = userdata;
+	union tptest_event e = { .pinch.type = EVTYPE_PINCH,
+				 .pinch.scale = scale };
+	push_event(d, &e);
+}
+
+static void
+swipe(struct tptest_device *d, enum tptest_event_type type,
+      unsigned int fingers, int dx, int dy)
+{
+	union tptest_event e = { .swipe.type = type,
+				 .swipe.fingers = fingers,
+				 .swipe.dx = dx,
+				 .swipe.dy = dy };
+	push_event(d, &e);
+}
+
+static void
+swipe_begin(struct touchpad *tp, void *userdata, unsigned int fingers)
+{
+	swipe(userdata, EVTYPE_SWIPE_BEGIN, fingers, 0, 0);
+}
+
+static void
+swipe_update(struct touchpad *tp, void *userdata, unsigned int fingers, int dx, int dy)
+{
+	swipe(userdata, EVTYPE_SWIPE_UPDATE, fingers, dx, dy);
+}
+
+static void
+swipe_end(struct touchpad *tp, void *userdata, unsigned int fingers)
+{
+	swipe(userdata, EVTYPE_SWIPE_END, fingers, 0, 0);
+}
+
+static void
+hold_begin(struct touchpad *tp, void *userdata)
+{
+	struct tptest_device *d = userdata;
+	union tptest_event e = { .hold.type = EVTYPE_HOLD_BEGIN };
+	push_event(d, &e);
+}
+
+static void
+hold_end(struct touchpad *tp, void *userdata, bool cancelled)
+{
+	struct tptest_device *d = userdata;
+	union tptest_event e = { .hold.type = EVTYPE_HOLD_END,
+				 .hold.cancelled = cancelled };
+	push_event(d, &e);
+}
+
+static void
+symbol(struct touchpad *tp, void *userdata, int id)
+{
+	struct tptest_device *d = userdata;
+	union tptest_event e = { .symbol.type = EVTYPE_SYMBOL,
+				 .symbol.id = id };
+	push_event(d, &e);
 }
 
 static const struct touchpad_interface interface = {
@@ -353,8 +437,63 @@ static const struct touchpad_interface interface = {
 	.scroll = scroll,
 	.rotate = rotate,
 	.pinch = pinch,
+	.swipe_begin = swipe_begin,
+	.swipe_update = swipe_update,
+	.swipe_end = swipe_end,
+	.hold_begin = hold_begin,
+	.hold_end = hold_end,
+	.symbol = symbol,
 };
 
+/* only the callbacks that aren't optional */
+static const struct touchpad_interface basic_interface = {
+	.motion = motion,
+	.button = button,
+	.tap = tap,
+	.scroll = scroll,
+};
+
+void
+tptest_use_basic_interface(struct tptest_device *d)
+{
+	touchpad_set_interface_v2(d->touchpad, &basic_interface, sizeof(basic_interface));
+}
+
+static const struct touchpad_interface hires_interface = {
+	.motion = motion,
+	.button = button,
+	.tap = tap,
+	.rotate = rotate,
+	.pinch = pinch,
+	.swipe_begin = swipe_begin,
+	.swipe_update = swipe_update,
+	.swipe_end = swipe_end,
+	.scroll_hires = scroll_hires,
+	.hold_begin = hold_begin,
+	.hold_end = hold_end,
+	.symbol = symbol,
+};
+
+void
+tptest_use_hires_scroll(struct tptest_device *d)
+{
+	touchpad_set_interface_v2(d->touchpad, &hires_interface, sizeof(hires_interface));
+}
+
+void
+tptest_use_v1_interface(struct tptest_device *d)
+{
+	/* a caller built against the interface that ended with pinch, the
+	   copy is freed right away */
+	size_t size = offsetof(struct touchpad_interface, swipe_begin);
+	struct touchpad_interface *iface = malloc(size);
+
+	ck_assert(iface != NULL);
+	memcpy(iface, &interface, size);
+	touchpad_set_interface(d->touchpad, iface);
+	free(iface);
+}
+
 static bool errors_allowed = false;
 
 static void
@@ -417,7 +556,7 @@ tptest_create_device(enum tptest_device_type which)
 
 	rc = touchpad_new_from_fd(fd, &d->touchpad);
 	ck_assert_int_eq(rc, 0);
-	touchpad_set_interface(d->touchpad, &interface);
+	touchpad_set_interface_v2(d->touchpad, &interface, sizeof(interface));
 
 	ck_assert(d->touchpad != NULL);
 
@@ -435,6 +574,24 @@ tptest_handle_events(struct tptest_device *d)
 	return touchpad_handle_events(d->touchpad, d);
 }
 
+/* Wait up to timeout ms for events or a library timer, 0 if neither came */
+int
+tptest_wait_for_events(struct tptest_device *d, int timeout)
+{
+	struct pollfd fds = {
+		.fd = touchpad_get_fd(d->touchpad),
+		.events = POLLIN,
+	};
+
+	if (poll(&fds, 1, timeout) <= 0)
+		return 0;
+
+	while (tptest_handle_events(d))
+		;
+
+	return 1;
+}
+
 void
 tptest_delete_device(struct tptest_device *d)
 {
@@ -472,6 +629,11 @@ tptest_touch_up(struct tptest_device *d, unsigned int slot)
 	};
 
 	d->d->touches_down &= ~slot;
+	if (d->d->touch_up) {
+		d->d->touch_up(d, slot);
+		return;
+	}
+
 	if (!d->d->touches_down) {
 		tptest_event(d, EV_KEY, BTN_TOUCH, 0);
 		tptest_event(d, EV_KEY, BTN_TOOL_FINGER, 0);
@@ -537,6 +699,39 @@ struct tptest_scroll_event *tptest_scroll_event(union tptest_event *e)
 	return &e->scroll;
 }
 
+struct tptest_pinch_event *tptest_pinch_event(union tptest_event *e)
+{
+	assert(e->type == EVTYPE_PINCH);
+	return &e->pinch;
+}
+
+struct tptest_rotate_event *tptest_rotate_event(union tptest_event *e)
+{
+	assert(e->type == EVTYPE_ROTATE);
+	return &e->rotate;
+}
+
+struct tptest_swipe_event *tptest_swipe_event(union tptest_event *e)
+{
+	assert(e->type == EVTYPE_SWIPE_BEGIN ||
+	       e->type == EVTYPE_SWIPE_UPDATE ||
+	       e->type == EVTYPE_SWIPE_END);
+	return &e->swipe;
+}
+
+struct tptest_hold_event *tptest_hold_event(union tptest_event *e)
+{
+	assert(e->type == EVTYPE_HOLD_BEGIN ||
+	       e->type == EVTYPE_HOLD_END);
+	return &e->hold;
+}
+
+struct tptest_symbol_event *tptest_symbol_event(union tptest_event *e)
+{
+	assert(e->type == EVTYPE_SYMBOL);
+	return &e->symbol;
+}
+
 int tptest_scale(const struct tptest_device *d, unsigned int axis, int val)
 {
 	ck_assert_int_ge(val, 0);
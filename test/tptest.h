@@ -33,6 +33,7 @@ enum tptest_device_type {
 	TOUCHPAD_SYNAPTICS_CLICKPAD = 0x1,
 	TOUCHPAD_BCM5974 = 0x2,
 	TOUCHPAD_SYNAPTICS_NON_MT = 0x4,
+	TOUCHPAD_SYNAPTICS_SEMI_MT = 0x8,
 
 	TOUCHPAD_ALL_MT_DEVICES = TOUCHPAD_SYNAPTICS_CLICKPAD|TOUCHPAD_BCM5974,
 	TOUCHPAD_ALL_DEVICES = TOUCHPAD_ALL_MT_DEVICES|TOUCHPAD_SYNAPTICS_NON_MT,
@@ -44,6 +45,14 @@ enum tptest_event_type {
 	EVTYPE_BUTTON,
 	EVTYPE_TAP,
 	EVTYPE_SCROLL,
+	EVTYPE_PINCH,
+	EVTYPE_ROTATE,
+	EVTYPE_SWIPE_BEGIN,
+	EVTYPE_SWIPE_UPDATE,
+	EVTYPE_SWIPE_END,
+	EVTYPE_HOLD_BEGIN,
+	EVTYPE_HOLD_END,
+	EVTYPE_SYMBOL,
 };
 
 struct tptest_motion_event {
@@ -66,15 +75,47 @@ struct tptest_tap_event {
 struct tptest_scroll_event {
 	enum tptest_event_type type;
 	double units;
+	int hires; /* only with tptest_use_hires_scroll() */
 	enum touchpad_scroll_direction dir;
 };
 
+struct tptest_pinch_event {
+	enum tptest_event_type type;
+	int scale;
+};
+
+struct tptest_rotate_event {
+	enum tptest_event_type type;
+	int degrees;
+};
+
+struct tptest_swipe_event {
+	enum tptest_event_type type;
+	unsigned fingers;
+	int dx, dy;
+};
+
+struct tptest_hold_event {
+	enum tptest_event_type type;
+	bool cancelled;
+};
+
+struct tptest_symbol_event {
+	enum tptest_event_type type;
+	int id;
+};
+
 union tptest_event {
 	enum tptest_event_type type;
 	struct tptest_motion_event motion;
 	struct tptest_button_event button;
 	struct tptest_tap_event tap;
 	struct tptest_scroll_event scroll;
+	struct tptest_pinch_event pinch;
+	struct tptest_rotate_event rotate;
+	struct tptest_swipe_event swipe;
+	struct tptest_hold_event hold;
+	struct tptest_symbol_event symbol;
 };
 
 struct tptest_device {
@@ -95,6 +136,7 @@ struct tptest_device * tptest_create_device(enum tptest_device_type which);
 struct tptest_device *tptest_current_device(void);
 void tptest_delete_device(struct tptest_device *d);
 int tptest_handle_events(struct tptest_device *d);
+int tptest_wait_for_events(struct tptest_device *d, int timeout);
 
 void tptest_event(struct tptest_device *t, unsigned int type, unsigned int code, int value);
 void tptest_touch_up(struct tptest_device *d, unsigned int slot);
@@ -102,11 +144,20 @@ void tptest_touch_move(struct tptest_device *d, unsigned int slot, int x, int y)
 void tptest_touch_down(struct tptest_device *d, unsigned int slot, int x, int y);
 void tptest_touch_move_to(struct tptest_device *d, unsigned int slot, int x_from, int y_from, int x_to, int y_to, int steps);
 void tptest_click(struct tptest_device *d, bool is_press);
+void tptest_use_basic_interface(struct tptest_device *d);
+void tptest_use_hires_scroll(struct tptest_device *d);
+void tptest_use_v1_interface(struct tptest_device *d);
+int tptest_scale(const struct tptest_device *d, unsigned int axis, int val);
 
 struct tptest_button_event *tptest_button_event(union tptest_event *e);
 struct tptest_motion_event *tptest_motion_event(union tptest_event *e);
 struct tptest_tap_event *tptest_tap_event(union tptest_event *e);
 struct tptest_scroll_event *tptest_scroll_event(union tptest_event *e);
+struct tptest_pinch_event *tptest_pinch_event(union tptest_event *e);
+struct tptest_rotate_event *tptest_rotate_event(union tptest_event *e);
+struct tptest_swipe_event *tptest_swipe_event(union tptest_event *e);
+struct tptest_hold_event *tptest_hold_event(union tptest_event *e);
+struct tptest_symbol_event *tptest_symbol_event(union tptest_event *e);
 void tptest_error(const char *msg, ...);
 #define argcheck_log(_file, _line, _func, msg, ...)  \
 	tptest_error("%s:%d %s(): " msg, _file, _line, _func, ## __VA_ARGS__)
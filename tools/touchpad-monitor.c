@@ -39,6 +39,7 @@
 #include <time.h>
 #include <unistd.h>
 #include "touchpad.h"
+#include "touchpad-config.h"
 
 struct tpdata {
 	int timerfd;
@@ -68,15 +69,71 @@ scroll(struct touchpad *tp, void *userdata, enum touchpad_scroll_direction dir,
 	printf("%50s %s scroll: %.2f\n", "", dir == TOUCHPAD_SCROLL_HORIZONTAL ? "horizontal" : "vertical", units);
 }
 
+static void
+rotate(struct touchpad *tp, void *userdata, int degrees)
+{
+	printf("%50s rotate: %d\n", "", degrees);
+}
+
+static void
+pinch(struct touchpad *tp, void *userdata, int scale)
+{
+	printf("%50s pinch: %d%%\n", "", scale);
+}
+
+static void
+swipe_begin(struct touchpad *tp, void *userdata, unsigned int fingers)
+{
+	printf("%50s swipe %d begin\n", "", fingers);
+}
+
+static void
+swipe_update(struct touchpad *tp, void *userdata, unsigned int fingers, int dx, int dy)
+{
+	printf("%50s swipe %d: %4d/%-4d\n", "", fingers, dx, dy);
+}
+
+static void
+swipe_end(struct touchpad *tp, void *userdata, unsigned int fingers)
+{
+	printf("%50s swipe %d end\n", "", fingers);
+}
+
+static void
+hold_begin(struct touchpad *tp, void *userdata)
+{
+	printf("%50s hold begin\n", "");
+}
+
+static void
+hold_end(struct touchpad *tp, void *userdata, bool cancelled)
+{
+	printf("%50s hold end%s\n", "", cancelled ? " (cancelled)" : "");
+}
+
+static void
+symbol(struct touchpad *tp, void *userdata, int id)
+{
+	printf("%50s symbol %d\n", "", id);
+}
+
 const struct touchpad_interface interface = {
 	.motion = motion,
 	.button = button,
 	.scroll = scroll,
 	.tap = tap,
+	.rotate = rotate,
+	.pinch = pinch,
+	.swipe_begin = swipe_begin,
+	.swipe_update = swipe_update,
+	.swipe_end = swipe_end,
+	.hold_begin = hold_begin,
+	.hold_end = hold_end,
+	.symbol = symbol,
 };
 
 int usage(void) {
-	printf("usage: %s /dev/input/event0\n", program_invocation_short_name);
+	printf("usage: %s /dev/input/event0 [symbol-templates]\n", program_invocation_short_name);
 	return 1;
 }
 
@@ -114,7 +171,23 @@ int main (int argc, char **argv) {
 
 	rc = touchpad_new_from_fd(fd, &tp);
 	assert(rc == 0);
-	touchpad_set_interface(tp, &interface);
+	touchpad_set_interface_v2(tp, &interface, sizeof(interface));
+
+	if (argc > 2) {
+		int gestures;
+
+		rc = touchpad_symbol_load_templates(tp, argv[2]);
+		if (rc != 0) {
+			fprintf(stderr, "Error loading the templates: %s\n", strerror(-rc));
+			return 1;
+		}
+
+		touchpad_config_get(tp, TOUCHPAD_CONFIG_GESTURES, &gestures,
+				    TOUCHPAD_CONFIG_NONE);
+		touchpad_config_set(tp, NULL,
+				    TOUCHPAD_CONFIG_GESTURES, gestures | TOUCHPAD_GESTURE_SYMBOL,
+				    TOUCHPAD_CONFIG_NONE);
+	}
 
 	mainloop(tp, &tpdata);
 
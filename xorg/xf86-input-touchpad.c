@@ -46,18 +46,6 @@ struct xf86touchpad {
 	char *path;
 	struct touchpad *tp;
 	OsTimerPtr timer;
-
-	int scroll_vdist;
-	int scroll_hdist;
-	int scroll_vdist_remainder;
-	int scroll_hdist_remainder;
-
-	struct {
-		double x;
-		double y;
-		double x_remainder;
-		double y_remainder;
-	} scale;
 };
 
 static inline struct touchpad*
@@ -144,7 +132,6 @@ static int
 xf86touchpad_init(DeviceIntPtr dev)
 {
 	InputInfoPtr pInfo = dev->public.devicePrivate;
-	struct xf86touchpad *touchpad = pInfo->private;
 	int min, max, res;
 
 	unsigned char btnmap[TOUCHPAD_MAX_BUTTONS + 1];
@@ -174,13 +161,9 @@ xf86touchpad_init(DeviceIntPtr dev)
 			           XIGetKnownProperty(AXIS_LABEL_PROP_REL_Y),
 				   min, max, res * 1000, 0, res * 1000, Relative);
 
-	touchpad_config_get(xf86touchpad(pInfo),
-			    TOUCHPAD_CONFIG_SCROLL_DELTA_HORIZ, &touchpad->scroll_hdist,
-			    TOUCHPAD_CONFIG_SCROLL_DELTA_VERT, &touchpad->scroll_vdist,
-			    TOUCHPAD_CONFIG_NONE);
-
-	SetScrollValuator(dev, 2, SCROLL_TYPE_HORIZONTAL, touchpad->scroll_hdist, 0);
-	SetScrollValuator(dev, 3, SCROLL_TYPE_VERTICAL, touchpad->scroll_vdist, 0);
+	/* one scroll unit from the library is one increment */
+	SetScrollValuator(dev, 2, SCROLL_TYPE_HORIZONTAL, TOUCHPAD_SCROLL_HIRES_UNITS, 0);
+	SetScrollValuator(dev, 3, SCROLL_TYPE_VERTICAL, TOUCHPAD_SCROLL_HIRES_UNITS, 0);
 
 	return Success;
 }
@@ -249,34 +232,23 @@ xf86touchpad_tap(struct touchpad *tp, void *userdata, unsigned int fingers, bool
 
 static void
 xf86touchpad_scroll(struct touchpad *tp, void *userdata,
-		    enum touchpad_scroll_direction direction, double units)
+		    enum touchpad_scroll_direction direction, int value)
 {
 	InputInfoPtr pInfo = userdata;
 	DeviceIntPtr dev = pInfo->dev;
-	struct xf86touchpad *touchpad = pInfo->private;
-	int first;
+	int first = (direction == TOUCHPAD_SCROLL_HORIZONTAL) ? 2 : 3;
 
-	switch(direction) {
-		case TOUCHPAD_SCROLL_HORIZONTAL:
-			first = 2;
-			units = units * touchpad->scroll_hdist + touchpad->scroll_hdist_remainder;
-			touchpad->scroll_hdist_remainder = (int)units % touchpad->scroll_hdist;
-			break;
-		case TOUCHPAD_SCROLL_VERTICAL:
-			first = 3;
-			units = units * touchpad->scroll_vdist + touchpad->scroll_vdist_remainder;
-			touchpad->scroll_vdist_remainder = (int)units % touchpad->scroll_vdist;
-			break;
-	}
+	if (value == 0)
+		return;
 
-	xf86PostMotionEvent(dev, Relative, first, 1, (int)units);
+	xf86PostMotionEvent(dev, Relative, first, 1, value);
 }
 
 static const struct touchpad_interface xf86touchpad_interface = {
 	.motion = xf86touchpad_motion,
 	.button = xf86touchpad_button,
-	.scroll = xf86touchpad_scroll,
 	.tap = xf86touchpad_tap,
+	.scroll_hires = xf86touchpad_scroll,
 };
 
 static void
@@ -294,24 +266,56 @@ static bool xf86touchpad_apply_config(InputInfoPtr pInfo,
 	const struct lookup {
 		const char *name; /* xorg.conf option name */
 		enum touchpad_config_parameter key;
+		int axis; /* option is in device units along this axis, or -1 */
 	} options[] = {
-		{ "MaxTapTime", TOUCHPAD_CONFIG_TAP_TIMEOUT },
-		{ "MaxTapMove", TOUCHPAD_CONFIG_TAP_MOVE_THRESHOLD },
-		{ "VertScrollDelta", TOUCHPAD_CONFIG_SCROLL_DELTA_VERT },
-		{ "VertScrollHoriz", TOUCHPAD_CONFIG_SCROLL_DELTA_HORIZ },
+		{ "MaxTapTime", TOUCHPAD_CONFIG_TAP_TIMEOUT, -1 },
+		{ "MaxTapMove", TOUCHPAD_CONFIG_TAP_MOVE_THRESHOLD, ABS_X },
+		{ "VertScrollDelta", TOUCHPAD_CONFIG_SCROLL_DELTA_VERT, ABS_Y },
+		{ "VertScrollHoriz", TOUCHPAD_CONFIG_SCROLL_DELTA_HORIZ, ABS_X },
+		{ "AccelProfile", TOUCHPAD_CONFIG_ACCEL_PROFILE, -1 },
+		{ "AccelMinFactor", TOUCHPAD_CONFIG_ACCEL_MIN_FACTOR, -1 },
+		{ "AccelMaxFactor", TOUCHPAD_CONFIG_ACCEL_MAX_FACTOR, -1 },
+		{ "AccelThreshold", TOUCHPAD_CONFIG_ACCEL_THRESHOLD, -1 },
+		{ "AccelMaxSpeed", TOUCHPAD_CONFIG_ACCEL_MAX_SPEED, -1 },
 	};
 	const struct lookup *opt;
 	enum touchpad_config_parameter scroll_methods = TOUCHPAD_SCROLL_NONE;
 	bool b;
 
-	pInfo->options = xf86ReplaceIntOption(pInfo->options, "ConstantDeceleration", 6);
+	/* The library accelerates, the server must pass the deltas on
+	 * as-is. The minimum factor replaces the ConstantDeceleration of 6
+	 * we used to have, touchpad device units are much smaller than
+	 * pixels. */
+	pInfo->options = xf86ReplaceIntOption(pInfo->options, "AccelerationProfile", -1);
+	pInfo->options = xf86ReplaceIntOption(pInfo->options, "ConstantDeceleration", 1);
+	if (touchpad_config_set(tp, NULL,
+				TOUCHPAD_CONFIG_ACCEL_PROFILE, TOUCHPAD_ACCEL_PROFILE_SMOOTH,
+				TOUCHPAD_CONFIG_ACCEL_MIN_FACTOR, 17,
+				TOUCHPAD_CONFIG_ACCEL_MAX_FACTOR, 70,
+				TOUCHPAD_CONFIG_NONE) != 0)
+		return false;
+
+	/* The server has no gesture events to post them as */
+	if (touchpad_config_set(tp, NULL,
+				TOUCHPAD_CONFIG_GESTURES, TOUCHPAD_GESTURE_NONE,
+				TOUCHPAD_CONFIG_NONE) != 0)
+		return false;
 
 	ARRAY_FOR_EACH(options, opt) {
 		int value = xf86SetIntOption(pInfo->options, opt->name, INT_MAX);
-		if (value != INT_MAX)
-			if (touchpad_config_set(tp, NULL, opt->key, value,
-						TOUCHPAD_CONFIG_NONE) != 0)
-				return false;
+		int res;
+
+		if (value == INT_MAX)
+			continue;
+
+		/* the library takes distances in µm */
+		if (opt->axis != -1 &&
+		    touchpad_get_min_max(tp, opt->axis, NULL, NULL, &res) == 0)
+			value = value * 1000/res;
+
+		if (touchpad_config_set(tp, NULL, opt->key, value,
+					TOUCHPAD_CONFIG_NONE) != 0)
+			return false;
 	}
 
 	b = xf86SetBoolOption(pInfo->options, "VertTwoFingerScroll", true);
@@ -325,23 +329,6 @@ static bool xf86touchpad_apply_config(InputInfoPtr pInfo,
 				   TOUCHPAD_CONFIG_NONE) == 0;
 }
 
-static bool xf86touchpad_calc_scale(struct xf86touchpad *touchpad)
-{
-	int hres, vres;
-
-	if (touchpad_get_min_max(touchpad->tp, ABS_MT_POSITION_X, NULL,
-				 NULL, &hres) != 0 ||
-	    touchpad_get_min_max(touchpad->tp, ABS_MT_POSITION_Y, NULL,
-				 NULL, &vres) != 0)
-		return false;
-
-	touchpad->scale.x = hres/(double)vres;
-	touchpad->scale.y = 1;
-
-	return true;
-
-}
-
 static void
 xf86touchpad_error_log(const char *format, va_list args)
 {
@@ -420,7 +407,8 @@ static int xf86touchpad_pre_init(InputDriverPtr drv,
 
 	touchpad_set_error_log_func(xf86touchpad_error_log);
 	touchpad_set_log_func(tp, xf86touchpad_log, pInfo);
-	touchpad_set_interface(tp, &xf86touchpad_interface);
+	touchpad_set_interface_v2(tp, &xf86touchpad_interface,
+				  sizeof(xf86touchpad_interface));
 	touchpad_change_fd(tp, -1);
 
 	if (!xf86touchpad_apply_config(pInfo, tp))
@@ -433,9 +421,6 @@ static int xf86touchpad_pre_init(InputDriverPtr drv,
 	driver_data->tp = tp;
 	driver_data->path = device;
 
-	if (!xf86touchpad_calc_scale(driver_data))
-		goto fail;
-
 	return Success;
 
 fail: